@@ -20,6 +20,7 @@ public class HUDFramework : ModuleRules
 				"ModularGameplay",
 				"AsyncMixin",
 				"ModelViewViewModel",
+				"NetCore",
 			}
 		);
 			
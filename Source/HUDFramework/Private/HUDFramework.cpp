@@ -2,5 +2,17 @@
 
 DEFINE_LOG_CATEGORY(LogHUDFramework);
 DEFINE_LOG_CATEGORY(LogIndicators);
+
+UE_TRACE_CHANNEL_DEFINE(HUDFrameworkChannel);
+
+// parent tag is deduced from the name, HUDFramework_WidgetPool_Slate is a child of HUDFramework_WidgetPool
+LLM_DEFINE_TAG(HUDFramework);
+LLM_DEFINE_TAG(HUDFramework_IndicatorCanvas);
+LLM_DEFINE_TAG(HUDFramework_WidgetPool);
+LLM_DEFINE_TAG(HUDFramework_WidgetPool_Objects);
+LLM_DEFINE_TAG(HUDFramework_WidgetPool_Slate);
+LLM_DEFINE_TAG(HUDFramework_WidgetContexts);
+LLM_DEFINE_TAG(HUDFramework_ViewModels);
+LLM_DEFINE_TAG(HUDFramework_LayoutRegistry);
 	
 IMPLEMENT_MODULE(FDefaultModuleImpl, HUDFramework)
\ No newline at end of file
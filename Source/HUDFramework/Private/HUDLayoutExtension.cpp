@@ -13,6 +13,29 @@ FHUDLayoutExtension::FHUDLayoutExtension(const FGameplayTag& InSlotTag, TSubclas
 	
 }
 
+FHUDLayoutExtension::FHUDLayoutExtension(const FGameplayTag& InSlotTag, const TSoftClassPtr<UUserWidget>& InWidgetClass, const ULocalPlayer* InLocalPlayer, const FHUDWidgetContextHandle& InContext)
+	: SlotTag(InSlotTag)
+	, PlayerContext(InLocalPlayer)
+	, WidgetClass(InWidgetClass.Get())
+	, SoftWidgetClass(InWidgetClass)
+	, WidgetContext(InContext)
+{
+	
+}
+
+FSoftObjectPath FHUDLayoutExtension::GetWidgetClassPath() const
+{
+	return WidgetClass.Get() != nullptr ? FSoftObjectPath{WidgetClass.Get()} : SoftWidgetClass.ToSoftObjectPath();
+}
+
+bool FHUDLayoutExtension::IsEquivalent(const FHUDLayoutExtension& Other) const
+{
+	return SlotTag == Other.SlotTag
+		&& PlayerContext == Other.PlayerContext
+		&& GetWidgetClassPath() == Other.GetWidgetClassPath()
+		&& WidgetContext.Identical(&Other.WidgetContext, PPF_None);
+}
+
 void FHUDLayoutExtensionHandle::Invalidate()
 {
 	Extension.Reset();
@@ -2,7 +2,10 @@
 
 #include "HUDFramework.h"
 #include "Blueprint/UserWidget.h"
+#include "HUDLayoutSubsystem.h"
 #include "HUDPrimaryLayout.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
 
 void FHUDPrimaryLayoutInstance::AddToViewport()
 {
@@ -77,6 +80,24 @@ void UHUDLayoutPolicy::OnPlayerControllerChanged(APlayerController* PlayerContro
 	{
 		return;
 	}
+
+	if (bKeepLayoutOnControllerChange)
+	{
+		if (FHUDPrimaryLayoutInstance* LayoutInstance = ActiveLayouts.FindByKey(LocalPlayer))
+		{
+			if (!IsValid(PlayerController))
+			{
+				// controller is being swapped, keep layout until the new one is assigned
+				return;
+			}
+			
+			if (CanKeepPrimaryLayout(*LayoutInstance, PlayerController))
+			{
+				KeepPrimaryLayout(*LayoutInstance, PlayerController);
+				return;
+			}
+		}
+	}
 	
 	RemovePrimaryLayout(LocalPlayer);
 	if (IsValid(PlayerController))
@@ -85,6 +106,66 @@ void UHUDLayoutPolicy::OnPlayerControllerChanged(APlayerController* PlayerContro
 	}
 }
 
+TSharedPtr<FStreamableHandle> UHUDLayoutPolicy::PreloadPrimaryLayout()
+{
+	if (IsPrimaryLayoutClassLoaded() || LayoutClassHandle.IsValid() || PrimaryLayoutClass.IsNull())
+	{
+		return LayoutClassHandle;
+	}
+
+	LayoutClassHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(PrimaryLayoutClass.ToSoftObjectPath(),
+		FStreamableDelegate::CreateUObject(this, &ThisClass::HandlePrimaryLayoutClassLoaded)
+	);
+	return LayoutClassHandle;
+}
+
+bool UHUDLayoutPolicy::IsPrimaryLayoutClassLoaded() const
+{
+	return PrimaryLayoutClass.Get() != nullptr;
+}
+
+void UHUDLayoutPolicy::HandlePrimaryLayoutClassLoaded()
+{
+	LayoutClassHandle.Reset();
+
+	TArray<TWeakObjectPtr<ULocalPlayer>> Players = MoveTemp(PendingPlayers);
+	if (!IsPrimaryLayoutClassLoaded())
+	{
+		UE_LOG(LogHUDFramework, Error, TEXT("%s: failed to load primary layout class %s"), *FString(__FUNCTION__), *PrimaryLayoutClass.ToString());
+		return;
+	}
+
+	for (const TWeakObjectPtr<ULocalPlayer>& LocalPlayer: Players)
+	{
+		// player controller might have been removed while layout class was loading
+		if (LocalPlayer.IsValid() && IsValid(LocalPlayer->PlayerController))
+		{
+			AddPrimaryLayout(LocalPlayer.Get());
+		}
+	}
+}
+
+bool UHUDLayoutPolicy::CanKeepPrimaryLayout(const FHUDPrimaryLayoutInstance& LayoutInstance, APlayerController* PlayerController) const
+{
+	return IsValid(LayoutInstance.PrimaryLayout) && LayoutInstance.PrimaryLayout->GetClass() == PrimaryLayoutClass.Get();
+}
+
+void UHUDLayoutPolicy::KeepPrimaryLayout(FHUDPrimaryLayoutInstance& LayoutInstance, APlayerController* PlayerController)
+{
+	UHUDPrimaryLayout* PrimaryLayout = LayoutInstance.PrimaryLayout;
+	UE_LOG(LogHUDFramework, Log, TEXT("Keeping primary layout [%s] for player controller [%s]"), *GetNameSafe(PrimaryLayout), *GetNameSafe(PlayerController));
+	
+	if (PrimaryLayout->GetOuter() != PlayerController)
+	{
+		// widget is owned by the old player controller, which is about to be destroyed
+		PrimaryLayout->Rename(nullptr, PlayerController, REN_DontCreateRedirectors | REN_DoNotDirty | REN_NonTransactional);
+	}
+	PrimaryLayout->UpdatePlayerContext(FLocalPlayerContext{PlayerController});
+	LayoutInstance.AddToViewport();
+
+	OnPrimaryLayoutKept(LayoutInstance.LocalPlayer, PrimaryLayout);
+}
+
 UWorld* UHUDLayoutPolicy::GetWorld() const
 {
 	return GetOuter()->GetWorld();
@@ -97,6 +178,12 @@ void UHUDLayoutPolicy::AddPrimaryLayout(ULocalPlayer* LocalPlayer)
 		UE_LOG(LogHUDFramework, Warning, TEXT("%s: local player [%s] readded to layout policy."), *FString(__FUNCTION__), *GetNameSafe(LocalPlayer));
 		LayoutInstance->AddToViewport();
 	}
+	else if (!IsPrimaryLayoutClassLoaded())
+	{
+		// don't block on layout class load, primary layout is created once it is loaded
+		PendingPlayers.AddUnique(LocalPlayer);
+		PreloadPrimaryLayout();
+	}
 	else
 	{
 		if (UHUDPrimaryLayout* LayoutWidget = CreatePrimaryLayout(LocalPlayer))
@@ -107,6 +194,11 @@ void UHUDLayoutPolicy::AddPrimaryLayout(ULocalPlayer* LocalPlayer)
 
 			Instance.AddToViewport();
 			OnPrimaryLayoutAdded(LocalPlayer, LayoutWidget);
+
+			if (UHUDLayoutSubsystem* LayoutSubsystem = GetTypedOuter<UHUDLayoutSubsystem>())
+			{
+				LayoutSubsystem->NotifyPrimaryLayoutReady(LocalPlayer, LayoutWidget);
+			}
 		}
 		else
 		{
@@ -123,7 +215,7 @@ void UHUDLayoutPolicy::RemovePrimaryLayout(ULocalPlayer* LocalPlayer)
 		ActiveLayouts[LayoutIndex].RemoveFromViewport();
 		ActiveLayouts.RemoveAtSwap(LayoutIndex);
 	}
-	else
+	else if (PendingPlayers.Remove(LocalPlayer) == 0)
 	{
 		UE_LOG(LogHUDFramework, Log, TEXT("%s: local player [%s] missing primary layout instance, probably because of nullptr player controller"), *FString(__FUNCTION__), *GetNameSafe(LocalPlayer));
 	}
@@ -144,11 +236,15 @@ void UHUDLayoutPolicy::OnPrimaryLayoutRemoved(ULocalPlayer* LocalPlayer, UHUDPri
 {
 }
 
+void UHUDLayoutPolicy::OnPrimaryLayoutKept(ULocalPlayer* LocalPlayer, UHUDPrimaryLayout* Layout)
+{
+}
+
 UHUDPrimaryLayout* UHUDLayoutPolicy::CreatePrimaryLayout(ULocalPlayer* LocalPlayer) const
 {
 	if (APlayerController* PlayerController = LocalPlayer->GetPlayerController(GetWorld()))
 	{
-		if (TSubclassOf<UHUDPrimaryLayout> LayoutClass = PrimaryLayoutClass.LoadSynchronous())
+		if (TSubclassOf<UHUDPrimaryLayout> LayoutClass = PrimaryLayoutClass.Get())
 		{
 			UHUDPrimaryLayout* PrimaryLayout = CreateWidget<UHUDPrimaryLayout>(PlayerController, LayoutClass);
 			return PrimaryLayout;
@@ -4,9 +4,10 @@
 #include "HUDLayoutSubsystem.h"
 #include "Blueprint/UserWidget.h"
 
-FHUDLayoutSlot::FHUDLayoutSlot(const FGameplayTag& InSlotTag, const ULocalPlayer* InLocalPlayer, TSlotCallback&& InAddCallback, TSlotCallback&& InRemoveCallback)
+FHUDLayoutSlot::FHUDLayoutSlot(const FGameplayTag& InSlotTag, const ULocalPlayer* InLocalPlayer, EHUDLayoutSlotMatch InMatchType, TSlotCallback&& InAddCallback, TSlotCallback&& InRemoveCallback)
 	: SlotTag(InSlotTag)
 	, PlayerContext(InLocalPlayer)
+	, MatchType(InMatchType)
 	, AddExtension(InAddCallback)
 	, RemoveExtension(InRemoveCallback)
 {
@@ -15,7 +16,8 @@ FHUDLayoutSlot::FHUDLayoutSlot(const FGameplayTag& InSlotTag, const ULocalPlayer
 
 bool FHUDLayoutSlot::ExtensionPassesRequirements(const TSharedPtr<FHUDLayoutExtension>& Extension) const
 {
-	return SlotTag == Extension->SlotTag && Extension->PlayerContext == PlayerContext && Extension->WidgetClass.Get() != nullptr;
+	const bool bTagMatches = MatchType == EHUDLayoutSlotMatch::PartialMatch ? Extension->SlotTag.MatchesTag(SlotTag) : Extension->SlotTag == SlotTag;
+	return bTagMatches && Extension->PlayerContext == PlayerContext && Extension->HasWidgetClass();
 }
 
 FHUDLayoutSlotHandle FHUDLayoutSlotHandle::EmptyHandle{};
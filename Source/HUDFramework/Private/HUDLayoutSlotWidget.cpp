@@ -1,9 +1,14 @@
 ﻿#include "HUDLayoutSlotWidget.h"
 
+#include "HUDFramework.h"
 #include "HUDLayoutExtension.h"
 #include "HUDLayoutSubsystem.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
 #include "ViewModel/HUDWidgetContextSubsystem.h"
 
+DECLARE_CYCLE_STAT(TEXT("CreateExtensionWidget"), STAT_HUD_Framework_CreateExtensionWidget, STATGROUP_HUD_Framework);
+
 UHUDLayoutSlotWidget::UHUDLayoutSlotWidget(const FObjectInitializer& Initializer): Super(Initializer)
 {
 	
@@ -14,6 +19,7 @@ void UHUDLayoutSlotWidget::ReleaseSlateResources(bool bReleaseChildren)
 	if (!HasAnyFlags(RF_ClassDefaultObject))
 	{
 		UnregisterSlot();
+		CancelPendingExtensions();
 		ResetInternal();
 	}
 	
@@ -70,7 +76,10 @@ void UHUDLayoutSlotWidget::RegisterSlot()
 		FHUDLayoutSlotHandle Handle = LayoutSubsystem->RegisterLayoutSlot(SlotTag,
 			GetOwningLocalPlayer(),
 			[this](const FHUDLayoutExtensionRequest& Request) { return AddExtension(Request);	},
-			[this](const FHUDLayoutExtensionRequest& Request) { return RemoveExtension(Request); }
+			[this](const FHUDLayoutExtensionRequest& Request) { return RemoveExtension(Request); },
+			SlotMatch,
+			[this](TConstArrayView<FHUDLayoutExtensionRequest> Requests, TArray<UUserWidget*>& OutWidgets) { AddExtensions(Requests, OutWidgets); },
+			[this](const FHUDLayoutExtensionRequest& From, const FHUDLayoutExtensionRequest& To) { return MoveExtension(From, To); }
 		);
 		Handles.Add(Handle);
 	}
@@ -95,6 +104,46 @@ void UHUDLayoutSlotWidget::UnregisterSlot()
 
 UUserWidget* UHUDLayoutSlotWidget::AddExtension(const FHUDLayoutExtensionRequest& Request)
 {
+	if (Request.WidgetClass.Get() == nullptr)
+	{
+		return RequestExtensionClass(Request);
+	}
+	
+	UUserWidget* Widget = CreateExtensionWidget(Request);
+	AttachExtensionWidget(Widget, Request);
+
+	return Widget;
+}
+
+void UHUDLayoutSlotWidget::AddExtensions(TConstArrayView<FHUDLayoutExtensionRequest> Requests, TArray<UUserWidget*>& OutWidgets)
+{
+	OutWidgets.Reserve(OutWidgets.Num() + Requests.Num());
+	
+	const int32 StartIndex = OutWidgets.Num();
+	for (const FHUDLayoutExtensionRequest& Request: Requests)
+	{
+		OutWidgets.Add(Request.WidgetClass.Get() != nullptr ? CreateExtensionWidget(Request) : nullptr);
+	}
+
+	for (int32 Index = 0; Index < Requests.Num(); ++Index)
+	{
+		if (UUserWidget* Widget = OutWidgets[StartIndex + Index])
+		{
+			AttachExtensionWidget(Widget, Requests[Index]);
+		}
+		else
+		{
+			OutWidgets[StartIndex + Index] = RequestExtensionClass(Requests[Index]);
+		}
+	}
+}
+
+UUserWidget* UHUDLayoutSlotWidget::CreateExtensionWidget(const FHUDLayoutExtensionRequest& Request)
+{
+	SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_CreateExtensionWidget);
+	// extension widgets are created while slots are notified from layout registry
+	LLM_SCOPE(ELLMTag::UI);
+	
 	// not using widget pool, because it constructs widget even before adding it to panel widget
 	UUserWidget* Widget = CreateWidget<UUserWidget>(this, Request.WidgetClass);
 	// initialize widget with widget context using specified subsystem. It is done so we can add this widget as a child right away
@@ -102,6 +151,23 @@ UUserWidget* UHUDLayoutSlotWidget::AddExtension(const FHUDLayoutExtensionRequest
 	{
 		Subsystem->InitializeWidget(Widget, Request.WidgetContext);
 	}
+
+	return Widget;
+}
+
+void UHUDLayoutSlotWidget::AttachExtensionWidget(UUserWidget* Widget, const FHUDLayoutExtensionRequest& Request)
+{
+	AddEntryWidget(Widget);
+	
+	if (ConfigureWidget.IsBound())
+	{
+		ConfigureWidget.Execute(Widget, Request.WidgetContext);
+	}
+	ActiveExtensions.Add(Request.Handle, Widget);
+}
+
+void UHUDLayoutSlotWidget::AddEntryWidget(UUserWidget* Widget)
+{
 	if (MyPanelWidget.IsValid())
 	{
 		AddEntryChild(*Widget);
@@ -110,25 +176,169 @@ UUserWidget* UHUDLayoutSlotWidget::AddExtension(const FHUDLayoutExtensionRequest
 	{
 		PendingWidgets.Add(Widget);
 	}
+}
+
+UUserWidget* UHUDLayoutSlotWidget::RequestExtensionClass(const FHUDLayoutExtensionRequest& Request)
+{
+	if (UClass* WidgetClass = Request.SoftWidgetClass.Get())
+	{
+		// already loaded by someone else
+		FHUDLayoutExtensionRequest LoadedRequest = Request;
+		LoadedRequest.WidgetClass = WidgetClass;
+		return AddExtension(LoadedRequest);
+	}
+
+	if (PlaceholderWidgetClass.Get() != nullptr)
+	{
+		UUserWidget* Placeholder = CreateWidget<UUserWidget>(this, PlaceholderWidgetClass);
+		AddEntryWidget(Placeholder);
+		ActiveExtensions.Add(Request.Handle, Placeholder);
+	}
+
+	PendingExtensions.Add(Request.Handle, FPendingExtension{Request});
 	
-	if (ConfigureWidget.IsBound())
+	FStreamableManager& StreamableManager = UAssetManager::Get().GetStreamableManager();
+	TSharedPtr<FStreamableHandle> StreamableHandle = StreamableManager.RequestAsyncLoad(Request.SoftWidgetClass.ToSoftObjectPath(),
+		FStreamableDelegate::CreateUObject(this, &ThisClass::HandleExtensionClassLoaded, Request.Handle)
+	);
+	// load may complete or be cancelled synchronously
+	if (FPendingExtension* PendingExtension = PendingExtensions.Find(Request.Handle))
 	{
-		ConfigureWidget.Execute(Widget, Request.WidgetContext);
+		PendingExtension->StreamableHandle = StreamableHandle;
 	}
-	ActiveExtensions.Add(Request.Handle, Widget);
 
-	return Widget;
+	// extension widget is reported to layout subsystem once it is created
+	return nullptr;
+}
+
+void UHUDLayoutSlotWidget::HandleExtensionClassLoaded(FHUDLayoutExtensionHandle Handle)
+{
+	if (!PendingExtensions.Contains(Handle))
+	{
+		// extension was removed while loading
+		return;
+	}
+
+	CreationQueue.Add(Handle);
+	if (!CreationTickerHandle.IsValid())
+	{
+		CreationTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::ProcessCreationQueue));
+	}
+}
+
+bool UHUDLayoutSlotWidget::ProcessCreationQueue(float DeltaTime)
+{
+	UHUDLayoutSubsystem* LayoutSubsystem = GetGameInstance() ? GetGameInstance()->GetSubsystem<UHUDLayoutSubsystem>() : nullptr;
+	if (LayoutSubsystem == nullptr)
+	{
+		CreationQueue.Reset();
+		CreationTickerHandle.Reset();
+		return false;
+	}
+	
+	int32 NumProcessed = 0;
+	for (; NumProcessed < CreationQueue.Num(); ++NumProcessed)
+	{
+		const FHUDLayoutExtensionHandle Handle = CreationQueue[NumProcessed];
+		if (!PendingExtensions.Contains(Handle))
+		{
+			// extension was removed after its class has been loaded
+			continue;
+		}
+
+		if (!LayoutSubsystem->TryConsumeExtensionWidgetBudget())
+		{
+			break;
+		}
+
+		FPendingExtension PendingExtension;
+		PendingExtensions.RemoveAndCopyValue(Handle, PendingExtension);
+
+		// replace placeholder with extension widget
+		if (UUserWidget* Placeholder = ActiveExtensions.FindRef(Handle))
+		{
+			RemoveEntryInternal(Placeholder);
+			ActiveExtensions.Remove(Handle);
+		}
+
+		FHUDLayoutExtensionRequest& Request = PendingExtension.Request;
+		Request.WidgetClass = Request.SoftWidgetClass.Get();
+		if (Request.WidgetClass.Get() == nullptr)
+		{
+			UE_LOG(LogHUDFramework, Error, TEXT("%s: failed to load widget class [%s] for slot [%s]"), *FString(__FUNCTION__), *Request.SoftWidgetClass.ToString(), *SlotTag.ToString());
+			continue;
+		}
+		
+		UUserWidget* Widget = CreateExtensionWidget(Request);
+		AttachExtensionWidget(Widget, Request);
+		LayoutSubsystem->NotifyExtensionWidgetCreated(Widget, Request.Handle);
+	}
+	// queue may be cleared by widget callbacks
+	CreationQueue.RemoveAt(0, FMath::Min(NumProcessed, CreationQueue.Num()), EAllowShrinking::No);
+
+	if (CreationQueue.IsEmpty())
+	{
+		CreationTickerHandle.Reset();
+		return false;
+	}
+	return true;
+}
+
+void UHUDLayoutSlotWidget::CancelPendingExtensions()
+{
+	for (auto& [Handle, PendingExtension]: PendingExtensions)
+	{
+		if (PendingExtension.StreamableHandle.IsValid())
+		{
+			PendingExtension.StreamableHandle->CancelHandle();
+		}
+	}
+	PendingExtensions.Empty();
+	CreationQueue.Empty();
+
+	if (CreationTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(CreationTickerHandle);
+		CreationTickerHandle.Reset();
+	}
 }
 
 UUserWidget* UHUDLayoutSlotWidget::RemoveExtension(const FHUDLayoutExtensionRequest& Request)
 {
+	FPendingExtension PendingExtension;
+	const bool bPending = PendingExtensions.RemoveAndCopyValue(Request.Handle, PendingExtension);
+	if (bPending && PendingExtension.StreamableHandle.IsValid())
+	{
+		// cancel pending load, queued widget creation is skipped
+		PendingExtension.StreamableHandle->CancelHandle();
+	}
+	
 	if (UUserWidget* Widget = ActiveExtensions.FindRef(Request.Handle))
 	{
 		RemoveEntryInternal(Widget);
 		ActiveExtensions.Remove(Request.Handle);
 
-		return Widget;
+		// placeholder was never reported as extension widget
+		return bPending ? nullptr : Widget;
 	}
 
 	return nullptr;
 }
+
+bool UHUDLayoutSlotWidget::MoveExtension(const FHUDLayoutExtensionRequest& From, const FHUDLayoutExtensionRequest& To)
+{
+	if (PendingExtensions.Contains(From.Handle))
+	{
+		// extension widget is not created yet, let slot restart the request
+		return false;
+	}
+
+	UUserWidget* Widget = nullptr;
+	if (!ActiveExtensions.RemoveAndCopyValue(From.Handle, Widget))
+	{
+		return false;
+	}
+
+	ActiveExtensions.Add(To.Handle, Widget);
+	return true;
+}
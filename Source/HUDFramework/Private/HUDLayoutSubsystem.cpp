@@ -5,6 +5,28 @@
 #include "HUDLayoutPolicy.h"
 #include "HUDFrameworkSettings.h"
 #include "HUDLayoutSlot.h"
+#include "HUDPrimaryLayout.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Misc/CoreDelegates.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+DECLARE_CYCLE_STAT(TEXT("NotifySlot"),					STAT_HUD_Framework_NotifySlot,				STATGROUP_HUD_Framework);
+DECLARE_CYCLE_STAT(TEXT("NotifyExtension"),				STAT_HUD_Framework_NotifyExtension,			STATGROUP_HUD_Framework);
+DECLARE_CYCLE_STAT(TEXT("NotifyExtensionBatch"),		STAT_HUD_Framework_NotifyExtensionBatch,	STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Extensions Dispatched"),	STAT_HUD_Framework_ExtensionsDispatched,	STATGROUP_HUD_Framework);
+
+TRACE_DECLARE_INT_COUNTER(HUDFramework_ExtensionsDispatched, TEXT("HUDFramework/ExtensionsDispatched"));
+
+namespace HUDLayoutSubsystem
+{
+	/** track number of extension add/remove/move callbacks dispatched to slots */
+	FORCEINLINE void TrackExtensionsDispatched(int32 Num)
+	{
+		INC_DWORD_STAT_BY(STAT_HUD_Framework_ExtensionsDispatched, Num);
+		TRACE_COUNTER_ADD(HUDFramework_ExtensionsDispatched, Num);
+	}
+}
 
 UHUDLayoutSubsystem* UHUDLayoutSubsystem::Get(const UObject* WorldContextObject)
 {
@@ -49,8 +71,17 @@ void UHUDLayoutSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 	const UHUDFrameworkSettings* Settings = GetDefault<UHUDFrameworkSettings>();
 	if (Policy == nullptr && !Settings->PolicyClass.IsNull())
 	{
-		TSubclassOf<UHUDLayoutPolicy> PolicyClass = Settings->PolicyClass.LoadSynchronous();
-		Policy = NewObject<UHUDLayoutPolicy>(this, PolicyClass);
+		if (TSubclassOf<UHUDLayoutPolicy> PolicyClass = Settings->PolicyClass.Get())
+		{
+			CreatePolicy(PolicyClass);
+		}
+		else
+		{
+			// don't block startup, local players are passed to the policy once it is created
+			PolicyClassHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Settings->PolicyClass.ToSoftObjectPath(),
+				FStreamableDelegate::CreateUObject(this, &ThisClass::HandlePolicyClassLoaded)
+			);
+		}
 	}
 	else
 	{
@@ -64,7 +95,25 @@ void UHUDLayoutSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 
 void UHUDLayoutSubsystem::Deinitialize()
 {
+	CommitFrameTransaction();
+	
+	if (PolicyClassHandle.IsValid())
+	{
+		PolicyClassHandle->CancelHandle();
+		PolicyClassHandle.Reset();
+	}
 	Policy = nullptr;
+	PrimaryLayoutReadyDelegates.Empty();
+	for (auto& [LocalPlayer, LayoutIndex]: PlayerLayoutIndices)
+	{
+		LayoutIndex.ReleaseRegistrations();
+	}
+	PlayerLayoutIndices.Empty();
+	ReleasedLayoutIndices.Empty();
+	PendingExtensions.Empty();
+	ExtensionBatchDepth = 0;
+	DeferredRemovals.Empty();
+	LayoutTransactionDepth = 0;
 
 	UGameInstance* GameInstance = CastChecked<UGameInstance>(GetOuter());
 	GameInstance->OnLocalPlayerAddedEvent.RemoveAll(this);
@@ -73,17 +122,97 @@ void UHUDLayoutSubsystem::Deinitialize()
 	Super::Deinitialize();
 }
 
-FHUDLayoutSlotHandle UHUDLayoutSubsystem::RegisterLayoutSlot(const FGameplayTag& SlotTag, const ULocalPlayer* LocalPlayer, TSlotCallback AddCallback, TSlotCallback RemoveCallback)
+void UHUDLayoutSubsystem::HandlePolicyClassLoaded()
+{
+	PolicyClassHandle.Reset();
+	
+	TSubclassOf<UHUDLayoutPolicy> PolicyClass = GetDefault<UHUDFrameworkSettings>()->PolicyClass.Get();
+	if (PolicyClass == nullptr)
+	{
+		UE_LOG(LogHUDFramework, Error, TEXT("%s: failed to load policy class"), *FString(__FUNCTION__));
+		return;
+	}
+
+	CreatePolicy(PolicyClass);
+
+	// local players added while policy class was loading
+	UGameInstance* GameInstance = CastChecked<UGameInstance>(GetOuter());
+	for (ULocalPlayer* LocalPlayer: GameInstance->GetLocalPlayers())
+	{
+		Policy->NotifyPlayerAdded(LocalPlayer);
+	}
+}
+
+void UHUDLayoutSubsystem::CreatePolicy(TSubclassOf<UHUDLayoutPolicy> PolicyClass)
+{
+	Policy = NewObject<UHUDLayoutPolicy>(this, PolicyClass);
+	if (bPreloadPrimaryLayout)
+	{
+		bPreloadPrimaryLayout = false;
+		Policy->PreloadPrimaryLayout();
+	}
+}
+
+void UHUDLayoutSubsystem::PreloadPrimaryLayout()
 {
+	if (Policy != nullptr)
+	{
+		Policy->PreloadPrimaryLayout();
+	}
+	else
+	{
+		bPreloadPrimaryLayout = true;
+	}
+}
+
+FDelegateHandle UHUDLayoutSubsystem::CallOrRegister_OnPrimaryLayoutReady(const ULocalPlayer* LocalPlayer, FPrimaryLayoutReadyDelegate::FDelegate Delegate)
+{
+	if (UHUDPrimaryLayout* PrimaryLayout = Policy != nullptr ? Policy->GetPrimaryLayout(LocalPlayer) : nullptr)
+	{
+		Delegate.ExecuteIfBound(PrimaryLayout);
+		return FDelegateHandle{};
+	}
+
+	return PrimaryLayoutReadyDelegates.FindOrAdd(LocalPlayer).Add(MoveTemp(Delegate));
+}
+
+void UHUDLayoutSubsystem::Unregister_OnPrimaryLayoutReady(const ULocalPlayer* LocalPlayer, FDelegateHandle Handle)
+{
+	if (FPrimaryLayoutReadyDelegate* Delegate = PrimaryLayoutReadyDelegates.Find(LocalPlayer))
+	{
+		Delegate->Remove(Handle);
+	}
+}
+
+void UHUDLayoutSubsystem::NotifyPrimaryLayoutReady(const ULocalPlayer* LocalPlayer, UHUDPrimaryLayout* PrimaryLayout)
+{
+	FPrimaryLayoutReadyDelegate Delegate;
+	if (PrimaryLayoutReadyDelegates.RemoveAndCopyValue(LocalPlayer, Delegate))
+	{
+		Delegate.Broadcast(PrimaryLayout);
+	}
+}
+
+bool UHUDLayoutSubsystem::IsPrimaryLayoutReady(const ULocalPlayer* LocalPlayer) const
+{
+	return Policy != nullptr && Policy->GetPrimaryLayout(LocalPlayer) != nullptr;
+}
+
+FHUDLayoutSlotHandle UHUDLayoutSubsystem::RegisterLayoutSlot(const FGameplayTag& SlotTag, const ULocalPlayer* LocalPlayer, TSlotCallback AddCallback, TSlotCallback RemoveCallback,
+	EHUDLayoutSlotMatch MatchType, TSlotBatchCallback BatchAddCallback, TSlotMoveCallback MoveCallback)
+{
+	LLM_SCOPE_BYTAG(HUDFramework_LayoutRegistry);
+	
 	if (!SlotTag.IsValid())
 	{
 		UE_LOG(LogHUDFramework, Error, TEXT("%s: invalid slot tag [%s]"), *FString(__FUNCTION__), *SlotTag.ToString());
 		return FHUDLayoutSlotHandle::EmptyHandle;
 	}
 
-	FLayoutSlotArray& Array = ActiveSlots.FindOrAdd(SlotTag);
-
-	TSharedPtr<FHUDLayoutSlot> Slot = Array.Add_GetRef(MakeShared<FHUDLayoutSlot>(SlotTag, LocalPlayer, MoveTemp(AddCallback), MoveTemp(RemoveCallback)));
+	TSharedPtr<FHUDLayoutSlot> Slot = MakeShared<FHUDLayoutSlot>(SlotTag, LocalPlayer, MatchType, MoveTemp(AddCallback), MoveTemp(RemoveCallback));
+	Slot->AddExtensions = MoveTemp(BatchAddCallback);
+	Slot->MoveExtension = MoveTemp(MoveCallback);
+	FindOrAddLayoutIndex(Slot->PlayerContext).AddSlot(Slot);
 	NotifySlotAdded(Slot);
 	
 	return FHUDLayoutSlotHandle{this, Slot};
@@ -103,9 +232,13 @@ void UHUDLayoutSubsystem::UnregisterLayoutSlot(FHUDLayoutSlotHandle& Handle)
 	// invalidate handle referencing slot instance
 	Handle.Invalidate();
 
-	// remove slot instance from slot array
-	FLayoutSlotArray& Array = ActiveSlots.FindChecked(Slot->SlotTag);
-	Array.Remove(Slot);
+	// remove slot instance from layout index
+	FHUDLayoutTagIndex* LayoutIndex = FindLayoutIndex(Slot->PlayerContext);
+	if (LayoutIndex == nullptr || !LayoutIndex->RemoveSlot(Slot))
+	{
+		// slot was released together with its local player
+		return;
+	}
 
 	NotifySlotRemoved(Slot);
 }
@@ -129,10 +262,42 @@ FHUDLayoutExtensionHandle UHUDLayoutSubsystem::RegisterLayoutExtensionWithContex
 		return FHUDLayoutExtensionHandle::EmptyHandle;
 	}
 	
-	FLayoutExtensionArray& Array = ActiveExtensions.FindOrAdd(SlotTag);
+	LLM_SCOPE_BYTAG(HUDFramework_LayoutRegistry);
+	return RegisterLayoutExtensionInternal(MakeShared<FHUDLayoutExtension>(SlotTag, WidgetClass, LocalPlayer, Context));
+}
 
-	TSharedPtr<FHUDLayoutExtension> Extension = Array.Add_GetRef(MakeShared<FHUDLayoutExtension>(SlotTag, WidgetClass, LocalPlayer, Context));
-	NotifyExtensionAdded(Extension);
+FHUDLayoutExtensionHandle UHUDLayoutSubsystem::RegisterLayoutExtensionWithSoftClass(const FGameplayTag& SlotTag, const TSoftClassPtr<UUserWidget>& WidgetClass, const ULocalPlayer* LocalPlayer, const FHUDWidgetContextHandle& Context)
+{
+	if (!SlotTag.IsValid())
+	{
+		UE_LOG(LogHUDFramework, Error, TEXT("%s: invalid slot tag [%s] for extension"), *FString(__FUNCTION__), *SlotTag.ToString());
+		return FHUDLayoutExtensionHandle::EmptyHandle;
+	}
+
+	if (WidgetClass.IsNull())
+	{
+		UE_LOG(LogHUDFramework, Error, TEXT("%s invalid widget for slot extension tag [%s]"), *FString(__FUNCTION__), *SlotTag.ToString());
+		return FHUDLayoutExtensionHandle::EmptyHandle;
+	}
+
+	LLM_SCOPE_BYTAG(HUDFramework_LayoutRegistry);
+	return RegisterLayoutExtensionInternal(MakeShared<FHUDLayoutExtension>(SlotTag, WidgetClass, LocalPlayer, Context));
+}
+
+FHUDLayoutExtensionHandle UHUDLayoutSubsystem::RegisterLayoutExtensionInternal(TSharedPtr<FHUDLayoutExtension> Extension)
+{
+	LLM_SCOPE_BYTAG(HUDFramework_LayoutRegistry);
+	FindOrAddLayoutIndex(Extension->PlayerContext).AddExtension(Extension);
+	if (IsExtensionBatchActive())
+	{
+		// notify slots when batch ends
+		Extension->bPendingNotify = true;
+		PendingExtensions.Add(Extension);
+	}
+	else
+	{
+		NotifyExtensionAdded(Extension);
+	}
 
 	return FHUDLayoutExtensionHandle{this, Extension};
 }
@@ -151,15 +316,195 @@ void UHUDLayoutSubsystem::UnregisterLayoutExtension(FHUDLayoutExtensionHandle& H
 	// invalidate handle referencing extension
 	Handle.Invalidate();
 
-	// remove extension from slot array
-	FLayoutExtensionArray& Array = ActiveExtensions.FindChecked(Extension->SlotTag);
-	Array.Remove(Extension);
+	// remove extension from layout index
+	FHUDLayoutTagIndex* LayoutIndex = FindLayoutIndex(Extension->PlayerContext);
+	const bool bRemoved = LayoutIndex != nullptr && LayoutIndex->RemoveExtension(Extension);
+
+	if (Extension->bPendingNotify)
+	{
+		// slots were never notified about this extension
+		Extension->bPendingNotify = false;
+		PendingExtensions.RemoveSingle(Extension);
+		return;
+	}
+
+	if (!bRemoved)
+	{
+		// extension was released together with its local player
+		return;
+	}
+
+	if (IsLayoutTransactionActive())
+	{
+		// notify slots when transaction is committed, widget may be reused by an equivalent extension
+		DeferredRemovals.Add(Extension);
+		return;
+	}
 	
 	NotifyExtensionRemoved(Extension); 
 }
 
+TArray<FHUDLayoutExtensionHandle> UHUDLayoutSubsystem::RegisterLayoutExtensions(TConstArrayView<FHUDLayoutExtensionParams> Params, const ULocalPlayer* LocalPlayer)
+{
+	FHUDLayoutExtensionBatchScope BatchScope{this};
+
+	TArray<FHUDLayoutExtensionHandle> Handles;
+	Handles.Reserve(Params.Num());
+	for (const FHUDLayoutExtensionParams& Param: Params)
+	{
+		Handles.Add(Param.WidgetClass.Get() != nullptr
+			? RegisterLayoutExtensionWithContext(Param.SlotTag, Param.WidgetClass, LocalPlayer, Param.WidgetContext)
+			: RegisterLayoutExtensionWithSoftClass(Param.SlotTag, Param.SoftWidgetClass, LocalPlayer, Param.WidgetContext)
+		);
+	}
+
+	return Handles;
+}
+
+void UHUDLayoutSubsystem::UnregisterLayoutExtensions(TArrayView<FHUDLayoutExtensionHandle> Handles)
+{
+	for (FHUDLayoutExtensionHandle& Handle: Handles)
+	{
+		UnregisterLayoutExtension(Handle);
+	}
+}
+
+void UHUDLayoutSubsystem::BeginExtensionBatch()
+{
+	++ExtensionBatchDepth;
+}
+
+void UHUDLayoutSubsystem::EndExtensionBatch()
+{
+	if (!ensureMsgf(ExtensionBatchDepth > 0, TEXT("%s: EndExtensionBatch called without matching BeginExtensionBatch"), *FString(__FUNCTION__)))
+	{
+		return;
+	}
+	
+	if (--ExtensionBatchDepth > 0 || PendingExtensions.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<TSharedPtr<FHUDLayoutExtension>> Extensions = MoveTemp(PendingExtensions);
+	for (const TSharedPtr<FHUDLayoutExtension>& Extension: Extensions)
+	{
+		// slots registered during notification pick up these extensions on their own
+		Extension->bPendingNotify = false;
+	}
+	
+	NotifyExtensionsAdded(Extensions);
+}
+
+void UHUDLayoutSubsystem::BeginLayoutTransaction()
+{
+	++LayoutTransactionDepth;
+	BeginExtensionBatch();
+}
+
+void UHUDLayoutSubsystem::CommitLayoutTransaction()
+{
+	if (!ensureMsgf(LayoutTransactionDepth > 0, TEXT("%s: CommitLayoutTransaction called without matching BeginLayoutTransaction"), *FString(__FUNCTION__)))
+	{
+		return;
+	}
+
+	if (--LayoutTransactionDepth == 0 && !DeferredRemovals.IsEmpty())
+	{
+		TArray<TSharedPtr<FHUDLayoutExtension>> Removals = MoveTemp(DeferredRemovals);
+		for (const TSharedPtr<FHUDLayoutExtension>& Removed: Removals)
+		{
+			const int32 AddedIndex = PendingExtensions.IndexOfByPredicate([&Removed](const TSharedPtr<FHUDLayoutExtension>& Added)
+			{
+				return Added->IsEquivalent(*Removed);
+			});
+
+			if (AddedIndex != INDEX_NONE)
+			{
+				// extension survived the transaction, hand its widgets over to the new extension
+				TSharedPtr<FHUDLayoutExtension> Added = PendingExtensions[AddedIndex];
+				PendingExtensions.RemoveAt(AddedIndex);
+				Added->bPendingNotify = false;
+
+				NotifyExtensionMoved(Removed, Added);
+			}
+			else
+			{
+				NotifyExtensionRemoved(Removed);
+			}
+		}
+	}
+
+	// notify slots about the rest of added extensions
+	EndExtensionBatch();
+}
+
+void UHUDLayoutSubsystem::BeginFrameTransaction(UHUDPrimaryLayout* PrimaryLayout)
+{
+	if (!FrameTransactionHandle.IsValid())
+	{
+		BeginLayoutTransaction();
+		FrameTransactionHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &ThisClass::CommitFrameTransaction);
+	}
+
+	if (PrimaryLayout != nullptr && !FrameTransactionLayouts.Contains(PrimaryLayout))
+	{
+		FrameTransactionLayouts.Add(PrimaryLayout);
+		PrimaryLayout->BeginLayerTransaction();
+	}
+}
+
+void UHUDLayoutSubsystem::CommitFrameTransaction()
+{
+	if (!FrameTransactionHandle.IsValid())
+	{
+		return;
+	}
+	
+	FCoreDelegates::OnEndFrame.Remove(FrameTransactionHandle);
+	FrameTransactionHandle.Reset();
+
+	for (const TWeakObjectPtr<UHUDPrimaryLayout>& PrimaryLayout: FrameTransactionLayouts)
+	{
+		if (PrimaryLayout.IsValid())
+		{
+			PrimaryLayout->CommitLayerTransaction();
+		}
+	}
+	FrameTransactionLayouts.Reset();
+
+	CommitLayoutTransaction();
+}
+
+bool UHUDLayoutSubsystem::TryConsumeExtensionWidgetBudget()
+{
+	if (ExtensionBudgetFrame != GFrameCounter)
+	{
+		ExtensionBudgetFrame = GFrameCounter;
+		NumExtensionWidgetsCreated = 0;
+	}
+
+	const int32 MaxWidgets = GetDefault<UHUDFrameworkSettings>()->ExtensionWidgetsPerFrame;
+	if (MaxWidgets > 0 && NumExtensionWidgetsCreated >= MaxWidgets)
+	{
+		return false;
+	}
+
+	++NumExtensionWidgetsCreated;
+	return true;
+}
+
+void UHUDLayoutSubsystem::NotifyExtensionWidgetCreated(UUserWidget* Widget, const FHUDLayoutExtensionHandle& Handle)
+{
+	if (Widget != nullptr && Handle.IsValid() && Handle.Extension->IsRegistered())
+	{
+		OnExtensionAdded.Broadcast(Widget, *Handle.Extension);
+	}
+}
+
 void UHUDLayoutSubsystem::NotifySlotAdded(TSharedPtr<FHUDLayoutSlot> Slot)
 {
+	SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_NotifySlot);
 	UE_LOG(LogHUDFramework, Verbose, TEXT("Slot [%s] added for [%s] local player"), *Slot->SlotTag.ToString(), *GetNameSafe(Slot->PlayerContext.Get()));
 
 	UpdateSlotExtensions(Slot, Slot->AddExtension, OnExtensionAdded);
@@ -167,87 +512,241 @@ void UHUDLayoutSubsystem::NotifySlotAdded(TSharedPtr<FHUDLayoutSlot> Slot)
 
 void UHUDLayoutSubsystem::NotifySlotRemoved(TSharedPtr<FHUDLayoutSlot> Slot)
 {
+	SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_NotifySlot);
 	UE_LOG(LogHUDFramework, Verbose, TEXT("Slot [%s] removed for [%s] context"), *Slot->SlotTag.ToString(), *GetNameSafe(Slot->PlayerContext.Get()));
 
 	UpdateSlotExtensions(Slot, Slot->RemoveExtension, OnExtensionRemoved);
 }
 
-void UHUDLayoutSubsystem::UpdateSlotExtensions(TSharedPtr<FHUDLayoutSlot> Slot, TSlotCallback& CallbackRef, FSlotExtensionDelegate& ExtensionDelegate)
+void UHUDLayoutSubsystem::NotifyExtensionsAdded(TConstArrayView<TSharedPtr<FHUDLayoutExtension>> Extensions)
 {
-	ForEachExtension(Slot->SlotTag, [&Slot, &CallbackRef, &ExtensionDelegate, this](TSharedPtr<FHUDLayoutExtension> Extension)
+	SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_NotifyExtensionBatch);
+	UE_LOG(LogHUDFramework, Verbose, TEXT("%d extensions added in batch"), Extensions.Num());
+
+	struct FSlotRequests
 	{
-		if (Slot->ExtensionPassesRequirements(Extension))
+		TSharedPtr<FHUDLayoutSlot> Slot;
+		TArray<FHUDLayoutExtensionRequest> Requests;
+	};
+
+	// gather extensions for each slot first, so every slot is updated only once
+	TArray<FSlotRequests> SlotRequests;
+	TMap<const FHUDLayoutSlot*, int32> SlotIndices;
+	for (const TSharedPtr<FHUDLayoutExtension>& Extension: Extensions)
+	{
+		ForEachSlot(*Extension, [&SlotRequests, &SlotIndices, &Extension, this](const TSharedPtr<FHUDLayoutSlot>& Slot)
 		{
-			FHUDLayoutExtensionRequest Request = CreateRequest(FHUDLayoutExtensionHandle{this, Extension});
-			UUserWidget* UserWidget = Invoke(CallbackRef, Request);
+			if (Slot->ExtensionPassesRequirements(Extension))
+			{
+				int32& Index = SlotIndices.FindOrAdd(Slot.Get(), INDEX_NONE);
+				if (Index == INDEX_NONE)
+				{
+					Index = SlotRequests.Add(FSlotRequests{Slot});
+				}
+				SlotRequests[Index].Requests.Add(CreateRequest(FHUDLayoutExtensionHandle{this, Extension}));
+			}
+		});
+	}
+
+	TArray<UUserWidget*> UserWidgets;
+	for (FSlotRequests& Entry: SlotRequests)
+	{
+		// slots and extensions may be unregistered by previous slot callbacks
+		if (!Entry.Slot->IsRegistered())
+		{
+			continue;
+		}
+		Entry.Requests.RemoveAll([](const FHUDLayoutExtensionRequest& Request)
+		{
+			return !Request.Handle.Extension->IsRegistered();
+		});
+
+		UserWidgets.Reset();
+		HUDLayoutSubsystem::TrackExtensionsDispatched(Entry.Requests.Num());
+		if (Entry.Slot->AddExtensions)
+		{
+			Entry.Slot->AddExtensions(Entry.Requests, UserWidgets);
+			check(UserWidgets.Num() == Entry.Requests.Num());
+		}
+		else
+		{
+			for (const FHUDLayoutExtensionRequest& Request: Entry.Requests)
+			{
+				UserWidgets.Add(Entry.Slot->AddExtension(Request));
+			}
+		}
+
+		for (int32 Index = 0; Index < Entry.Requests.Num(); ++Index)
+		{
+			// extensions with loading widget classes are reported once their widgets are created
+			if (UserWidgets[Index] != nullptr)
+			{
+				OnExtensionAdded.Broadcast(UserWidgets[Index], *Entry.Requests[Index].Handle.Extension);
+			}
+		}
+	}
+}
+
+void UHUDLayoutSubsystem::NotifyExtensionMoved(TSharedPtr<FHUDLayoutExtension> From, TSharedPtr<FHUDLayoutExtension> To)
+{
+	SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_NotifyExtension);
+	UE_LOG(LogHUDFramework, Verbose, TEXT("Extension moved for slot [%s] with [%s] local player"), *To->SlotTag.ToString(), *GetNameSafe(To->PlayerContext.Get()));
+
+	const FHUDLayoutExtensionRequest FromRequest = CreateRequest(FHUDLayoutExtensionHandle{this, From});
+	const FHUDLayoutExtensionRequest ToRequest = CreateRequest(FHUDLayoutExtensionHandle{this, To});
+	ForEachSlot(*To, [&FromRequest, &ToRequest, &From, &To, this](const TSharedPtr<FHUDLayoutSlot>& Slot)
+	{
+		if (!Slot->ExtensionPassesRequirements(To))
+		{
+			return;
+		}
+		
+		HUDLayoutSubsystem::TrackExtensionsDispatched(1);
+		if (!Slot->MoveExtension || !Slot->MoveExtension(FromRequest, ToRequest))
+		{
+			// slot can't reuse extension widget, replace it
+			// slot may never have held a widget for the old extension
+			if (UUserWidget* RemovedWidget = Slot->RemoveExtension(FromRequest))
+			{
+				OnExtensionRemoved.Broadcast(RemovedWidget, *From);
+			}
 
-			ExtensionDelegate.Broadcast(UserWidget, *Extension);
+			if (UUserWidget* AddedWidget = Slot->AddExtension(ToRequest))
+			{
+				OnExtensionAdded.Broadcast(AddedWidget, *To);
+			}
 		}
 	});
 }
 
-void UHUDLayoutSubsystem::ForEachSlot(FGameplayTag SlotTag, TFunctionRef<void( TSharedPtr<FHUDLayoutSlot> )> Func)
+void UHUDLayoutSubsystem::UpdateSlotExtensions(TSharedPtr<FHUDLayoutSlot> Slot, TSlotCallback& CallbackRef, FSlotExtensionDelegate& ExtensionDelegate)
 {
-	while (SlotTag.IsValid())
+	ForEachExtension(*Slot, [&Slot, &CallbackRef, &ExtensionDelegate, this](const TSharedPtr<FHUDLayoutExtension>& Extension)
 	{
-		if (const FLayoutSlotArray* ArrayPtr = ActiveSlots.Find(SlotTag))
+		// slots are notified about pending extensions when extension batch ends
+		if (!Extension->bPendingNotify && Slot->ExtensionPassesRequirements(Extension))
 		{
-			FLayoutSlotArray ArrayCopy(*ArrayPtr);
-			for (const TSharedPtr<FHUDLayoutSlot>& Slot: ArrayCopy)
+			FHUDLayoutExtensionRequest Request = CreateRequest(FHUDLayoutExtensionHandle{this, Extension});
+			HUDLayoutSubsystem::TrackExtensionsDispatched(1);
+			UUserWidget* UserWidget = Invoke(CallbackRef, Request);
+
+			if (UserWidget != nullptr)
 			{
-				Func(Slot);
+				ExtensionDelegate.Broadcast(UserWidget, *Extension);
 			}
 		}
+	});
+}
 
-		//@todo: full/partial match rules
-		SlotTag = SlotTag.RequestDirectParent();
+void UHUDLayoutSubsystem::ForEachSlot(const FHUDLayoutExtension& Extension, TFunctionRef<void( const TSharedPtr<FHUDLayoutSlot>& )> Func)
+{
+	if (const FHUDLayoutTagIndex* LayoutIndex = FindLayoutIndex(Extension.PlayerContext))
+	{
+		++LayoutIndexIterationDepth;
+		LayoutIndex->ForEachSlot(Extension.SlotTag, Func);
+		if (--LayoutIndexIterationDepth == 0 && !ReleasedLayoutIndices.IsEmpty())
+		{
+			RemoveReleasedLayoutIndices();
+		}
 	}
 }
 
-void UHUDLayoutSubsystem::ForEachExtension(FGameplayTag SlotTag, TFunctionRef<void( TSharedPtr<FHUDLayoutExtension> )> Func)
+void UHUDLayoutSubsystem::ForEachExtension(const FHUDLayoutSlot& Slot, TFunctionRef<void( const TSharedPtr<FHUDLayoutExtension>& )> Func)
 {
-	while (SlotTag.IsValid())
+	if (const FHUDLayoutTagIndex* LayoutIndex = FindLayoutIndex(Slot.PlayerContext))
 	{
-		if (const FLayoutExtensionArray* ArrayPtr = ActiveExtensions.Find(SlotTag))
+		++LayoutIndexIterationDepth;
+		LayoutIndex->ForEachExtension(Slot.SlotTag, Slot.MatchType, Func);
+		if (--LayoutIndexIterationDepth == 0 && !ReleasedLayoutIndices.IsEmpty())
 		{
-			FLayoutExtensionArray ArrayCopy(*ArrayPtr);
-			for (const TSharedPtr<FHUDLayoutExtension>& Extension: ArrayCopy)
-			{
-				Func(Extension);
-			}
+			RemoveReleasedLayoutIndices();
 		}
+	}
+}
 
-		//@todo: full/partial match rules
-		SlotTag = SlotTag.RequestDirectParent();
+FHUDLayoutTagIndex& UHUDLayoutSubsystem::FindOrAddLayoutIndex(const TWeakObjectPtr<const ULocalPlayer>& LocalPlayer)
+{
+	const TObjectKey<const ULocalPlayer> PlayerKey{LocalPlayer.Get(true)};
+	// released index is empty, keep it for new registrations instead of removing it after iteration
+	ReleasedLayoutIndices.RemoveSingleSwap(PlayerKey);
+	
+	return PlayerLayoutIndices.FindOrAdd(PlayerKey);
+}
+
+void UHUDLayoutSubsystem::ReleaseLayoutIndex(const ULocalPlayer* LocalPlayer)
+{
+	FHUDLayoutTagIndex* LayoutIndex = PlayerLayoutIndices.Find(LocalPlayer);
+	if (LayoutIndex == nullptr)
+	{
+		return;
+	}
+
+	// invalidate registrations right away, so handles of released slots and extensions are no longer registered
+	LayoutIndex->ReleaseRegistrations();
+	if (LayoutIndexIterationDepth > 0)
+	{
+		// tag nodes are still referenced by iteration in progress
+		ReleasedLayoutIndices.AddUnique(LocalPlayer);
+	}
+	else
+	{
+		PlayerLayoutIndices.Remove(LocalPlayer);
 	}
 }
 
+void UHUDLayoutSubsystem::RemoveReleasedLayoutIndices()
+{
+	for (const TObjectKey<const ULocalPlayer>& PlayerKey: ReleasedLayoutIndices)
+	{
+		PlayerLayoutIndices.Remove(PlayerKey);
+	}
+	ReleasedLayoutIndices.Reset();
+}
+
+const FHUDLayoutTagIndex* UHUDLayoutSubsystem::FindLayoutIndex(const TWeakObjectPtr<const ULocalPlayer>& LocalPlayer) const
+{
+	return PlayerLayoutIndices.Find(LocalPlayer.Get(true));
+}
+
+FHUDLayoutTagIndex* UHUDLayoutSubsystem::FindLayoutIndex(const TWeakObjectPtr<const ULocalPlayer>& LocalPlayer)
+{
+	return PlayerLayoutIndices.Find(LocalPlayer.Get(true));
+}
+
 void UHUDLayoutSubsystem::NotifyExtensionAdded(TSharedPtr<FHUDLayoutExtension> Extension)
 {
+	SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_NotifyExtension);
 	UE_LOG(LogHUDFramework, Verbose, TEXT("Extension added for slot [%s] with [%s] local player"), *Extension->SlotTag.ToString(), *GetNameSafe(Extension->PlayerContext.Get()));
 
 	FHUDLayoutExtensionRequest Request = CreateRequest(FHUDLayoutExtensionHandle{this, Extension});
-	ForEachSlot(Extension->SlotTag, [&Request, &Extension, this](TSharedPtr<FHUDLayoutSlot> Slot)
+	ForEachSlot(*Extension, [&Request, &Extension, this](const TSharedPtr<FHUDLayoutSlot>& Slot)
 	{
 		if (Slot->ExtensionPassesRequirements(Extension))
 		{
-			UUserWidget* UserWidget = Slot->AddExtension(Request);
-			OnExtensionAdded.Broadcast(UserWidget, *Extension);
+			HUDLayoutSubsystem::TrackExtensionsDispatched(1);
+			if (UUserWidget* UserWidget = Slot->AddExtension(Request))
+			{
+				OnExtensionAdded.Broadcast(UserWidget, *Extension);
+			}
 		}
 	});
 }
 
 void UHUDLayoutSubsystem::NotifyExtensionRemoved(TSharedPtr<FHUDLayoutExtension> Extension)
 {
+	SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_NotifyExtension);
 	UE_LOG(LogHUDFramework, Verbose, TEXT("Extension removed for slot [%s] with [%s] local player"), *Extension->SlotTag.ToString(), *GetNameSafe(Extension->PlayerContext.Get()));
 
 	FHUDLayoutExtensionRequest Request = CreateRequest(FHUDLayoutExtensionHandle{this, Extension});
-	ForEachSlot(Extension->SlotTag, [&Request, &Extension, this](TSharedPtr<FHUDLayoutSlot> Slot)
+	ForEachSlot(*Extension, [&Request, &Extension, this](const TSharedPtr<FHUDLayoutSlot>& Slot)
 	{
 		if (Slot->ExtensionPassesRequirements(Extension))
 		{
-			UUserWidget* UserWidget = Slot->RemoveExtension(Request);
-			OnExtensionRemoved.Broadcast(UserWidget, *Extension);
+			HUDLayoutSubsystem::TrackExtensionsDispatched(1);
+			if (UUserWidget* UserWidget = Slot->RemoveExtension(Request))
+			{
+				OnExtensionRemoved.Broadcast(UserWidget, *Extension);
+			}
 		}
 	});
 }
@@ -260,6 +759,7 @@ FHUDLayoutExtensionRequest UHUDLayoutSubsystem::CreateRequest(const FHUDLayoutEx
 	Request.Handle = Handle;
 	Request.SlotTag = Handle.Extension->SlotTag;
 	Request.WidgetClass = Handle.Extension->WidgetClass;
+	Request.SoftWidgetClass = Handle.Extension->SoftWidgetClass;
 	Request.WidgetContext = Handle.Extension->WidgetContext;
 
 	return Request;
@@ -294,4 +794,7 @@ void UHUDLayoutSubsystem::OnLocalPlayerRemoved(ULocalPlayer* LocalPlayer)
 	{
 		Policy->NotifyPlayerRemoved(LocalPlayer);
 	}
+
+	// release all slots and extensions registered for local player at once
+	ReleaseLayoutIndex(LocalPlayer);
 }
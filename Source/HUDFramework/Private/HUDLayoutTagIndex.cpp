@@ -0,0 +1,149 @@
+﻿#include "HUDLayoutTagIndex.h"
+
+void FHUDLayoutTagIndex::AddSlot(const FSlotPtr& Slot)
+{
+	Slot->RegistrationId = NextRegistrationId++;
+
+	FTagNode& Node = FindOrAddNode(Slot->SlotTag);
+	Node.Slots.Add(Slot);
+	if (Slot->MatchType == EHUDLayoutSlotMatch::PartialMatch)
+	{
+		Node.PartialSlots.Add(Slot);
+	}
+}
+
+bool FHUDLayoutTagIndex::RemoveSlot(const FSlotPtr& Slot)
+{
+	TUniquePtr<FTagNode>* NodePtr = Nodes.Find(Slot->SlotTag);
+	if (NodePtr == nullptr)
+	{
+		return false;
+	}
+
+	FTagNode& Node = **NodePtr;
+	if (!Node.Slots.Remove(Slot))
+	{
+		return false;
+	}
+	
+	Node.PartialSlots.Remove(Slot);
+	Slot->RegistrationId = 0;
+	return true;
+}
+
+void FHUDLayoutTagIndex::AddExtension(const FExtensionPtr& Extension)
+{
+	Extension->RegistrationId = NextRegistrationId++;
+
+	FTagNode& Node = FindOrAddNode(Extension->SlotTag);
+	Node.Extensions.Add(Extension);
+	Node.SubtreeExtensions.Add(Extension);
+	for (FTagNode* Ancestor: Node.Ancestors)
+	{
+		Ancestor->SubtreeExtensions.Add(Extension);
+	}
+}
+
+bool FHUDLayoutTagIndex::RemoveExtension(const FExtensionPtr& Extension)
+{
+	TUniquePtr<FTagNode>* NodePtr = Nodes.Find(Extension->SlotTag);
+	if (NodePtr == nullptr)
+	{
+		return false;
+	}
+
+	FTagNode& Node = **NodePtr;
+	if (!Node.Extensions.Remove(Extension))
+	{
+		return false;
+	}
+	
+	Node.SubtreeExtensions.Remove(Extension);
+	for (FTagNode* Ancestor: Node.Ancestors)
+	{
+		Ancestor->SubtreeExtensions.Remove(Extension);
+	}
+	Extension->RegistrationId = 0;
+	return true;
+}
+
+void FHUDLayoutTagIndex::ForEachSlot(const FGameplayTag& ExtensionTag, TFunctionRef<void(const FSlotPtr&)> Func) const
+{
+	const FTagNode* Node = FindNode(ExtensionTag);
+	if (Node == nullptr)
+	{
+		return;
+	}
+
+	// slots registered during iteration are not visited, they pick up existing extensions on their own
+	const uint64 MaxRegistrationId = NextRegistrationId;
+	Node->Slots.ForEach(MaxRegistrationId, Func);
+	for (const FTagNode* Ancestor: Node->Ancestors)
+	{
+		Ancestor->PartialSlots.ForEach(MaxRegistrationId, Func);
+	}
+}
+
+void FHUDLayoutTagIndex::ForEachExtension(const FGameplayTag& SlotTag, EHUDLayoutSlotMatch MatchType, TFunctionRef<void(const FExtensionPtr&)> Func) const
+{
+	const FTagNode* Node = FindNode(SlotTag);
+	if (Node == nullptr)
+	{
+		return;
+	}
+
+	// extensions registered during iteration are not visited, they notify existing slots on their own
+	const uint64 MaxRegistrationId = NextRegistrationId;
+	if (MatchType == EHUDLayoutSlotMatch::PartialMatch)
+	{
+		Node->SubtreeExtensions.ForEach(MaxRegistrationId, Func);
+	}
+	else
+	{
+		Node->Extensions.ForEach(MaxRegistrationId, Func);
+	}
+}
+
+void FHUDLayoutTagIndex::Reset()
+{
+	ReleaseRegistrations();
+	Nodes.Reset();
+}
+
+void FHUDLayoutTagIndex::ReleaseRegistrations()
+{
+	for (auto& [Tag, Node]: Nodes)
+	{
+		Node->Slots.Reset();
+		Node->PartialSlots.Reset();
+		Node->Extensions.Reset();
+		Node->SubtreeExtensions.Reset();
+	}
+}
+
+FHUDLayoutTagIndex::FTagNode& FHUDLayoutTagIndex::FindOrAddNode(const FGameplayTag& Tag)
+{
+	check(Tag.IsValid());
+	if (TUniquePtr<FTagNode>* NodePtr = Nodes.Find(Tag))
+	{
+		return **NodePtr;
+	}
+
+	TUniquePtr<FTagNode> NewNode = MakeUnique<FTagNode>();
+	const FGameplayTag ParentTag = Tag.RequestDirectParent();
+	if (ParentTag.IsValid())
+	{
+		// resolve tag hierarchy once, parent nodes are created on demand
+		FTagNode& ParentNode = FindOrAddNode(ParentTag);
+		NewNode->Ancestors.Add(&ParentNode);
+		NewNode->Ancestors.Append(ParentNode.Ancestors);
+	}
+
+	return *Nodes.Add(Tag, MoveTemp(NewNode));
+}
+
+const FHUDLayoutTagIndex::FTagNode* FHUDLayoutTagIndex::FindNode(const FGameplayTag& Tag) const
+{
+	const TUniquePtr<FTagNode>* NodePtr = Nodes.Find(Tag);
+	return NodePtr ? NodePtr->Get() : nullptr;
+}
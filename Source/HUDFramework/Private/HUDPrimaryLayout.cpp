@@ -23,17 +23,61 @@ void UHUDPrimaryLayout::PopWidget(UCommonActivatableWidget* Widget)
 	{
 		Layer->RemoveWidget(*Widget);
 	}
+	LayerWidgetContexts.Remove(Widget);
 }
 
 void UHUDPrimaryLayout::PopWidgetFromLayer(FGameplayTag LayerTag, UCommonActivatableWidget* Widget)
 {
-	if (Widget != nullptr)
+	if (Widget != nullptr && LayerTransactionDepth > 0)
+	{
+		DeferredPops.Add(FDeferredPop{LayerTag, Widget, LayerWidgetContexts.FindRef(Widget)});
+	}
+	else if (Widget != nullptr)
 	{
 		if (UCommonActivatableWidgetContainerBase* Layer = ActiveLayers.FindRef(LayerTag))
 		{
 			Layer->RemoveWidget(*Widget);
 		}
+		LayerWidgetContexts.Remove(Widget);
+	}
+}
+
+void UHUDPrimaryLayout::BeginLayerTransaction()
+{
+	++LayerTransactionDepth;
+}
+
+void UHUDPrimaryLayout::CommitLayerTransaction()
+{
+	if (!ensureMsgf(LayerTransactionDepth > 0, TEXT("%s: CommitLayerTransaction called without matching BeginLayerTransaction"), *FString(__FUNCTION__)))
+	{
+		return;
+	}
+
+	if (--LayerTransactionDepth == 0)
+	{
+		TArray<FDeferredPop> Pops = MoveTemp(DeferredPops);
+		for (const FDeferredPop& Pop: Pops)
+		{
+			PopWidgetFromLayer(Pop.LayerTag, Pop.Widget.Get());
+		}
+	}
+}
+
+UCommonActivatableWidget* UHUDPrimaryLayout::ReuseDeferredWidget(FGameplayTag LayerTag, UClass* WidgetClass, const FHUDWidgetContextHandle& WidgetContext)
+{
+	const int32 Index = DeferredPops.IndexOfByPredicate([LayerTag, WidgetClass, &WidgetContext](const FDeferredPop& Pop)
+	{
+		return Pop.LayerTag == LayerTag && Pop.Widget.IsValid() && Pop.Widget->GetClass() == WidgetClass && Pop.WidgetContext == WidgetContext;
+	});
+
+	if (Index != INDEX_NONE)
+	{
+		UCommonActivatableWidget* Widget = DeferredPops[Index].Widget.Get();
+		DeferredPops.RemoveAt(Index);
+		return Widget;
 	}
+	return nullptr;
 }
 
 UCommonActivatableWidgetContainerBase* UHUDPrimaryLayout::GetLayerWidget(FGameplayTag LayerTag) const
@@ -80,12 +124,31 @@ void UHUDPrimaryLayout::UnregisterLayer(FGameplayTag LayerTag)
 {
 	if (UCommonActivatableWidgetContainerBase* Layer = ActiveLayers.FindRef(LayerTag))
 	{
+		for (UCommonActivatableWidget* Widget: Layer->GetWidgetList())
+		{
+			LayerWidgetContexts.Remove(Widget);
+		}
 		Layer->ClearWidgets();
 	}
 	
 	ActiveLayers.Remove(LayerTag);
 }
 
+void UHUDPrimaryLayout::UpdatePlayerContext(const FLocalPlayerContext& InPlayerContext)
+{
+	// propagates to every user widget in the widget tree
+	SetPlayerContext(InPlayerContext);
+
+	// widgets pushed to layers are not part of the widget tree
+	for (auto& [LayerTag, Layer]: ActiveLayers)
+	{
+		for (UCommonActivatableWidget* Widget: Layer->GetWidgetList())
+		{
+			Widget->SetPlayerContext(InPlayerContext);
+		}
+	}
+}
+
 void UHUDPrimaryLayout::InitActivatableWidget(UCommonActivatableWidget& NewWidget)
 {
 	if (ActiveContext.IsValid())
@@ -1,8 +1,125 @@
 #include "HUDWidgetContext.h"
 
+#include "HUDFramework.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/PackageMapClient.h"
+#include "Misc/Crc.h"
+#include "Net/RepLayout.h"
+#include "UObject/UObjectIterator.h"
+
+namespace HUDWidgetContext
+{
+	/**
+	 * Stable net ids for widget context types
+	 * Id is a hash of the type path name, so it doesn't depend on which modules are loaded and never changes once used
+	 * Types sharing a hash are still registered, path name is sent along with their id
+	 */
+	class FTypeRegistry
+	{
+	public:
+		static FTypeRegistry& Get()
+		{
+			static FTypeRegistry Registry;
+			return Registry;
+		}
+
+		/**
+		 * @return net type id, 0 if @ContextType is not a widget context type
+		 * @bOutSendPath is set if other known types share the same id
+		 */
+		uint32 GetTypeId(const UScriptStruct* ContextType, bool& bOutSendPath)
+		{
+			RegisterLoadedTypes(false);
+			
+			const uint32* TypeId = TypeIds.Find(ContextType);
+			const uint32 Result = TypeId ? *TypeId : Register(ContextType);
+			bOutSendPath = Result != 0 && TypesById.FindChecked(Result).Num() > 1;
+			return Result;
+		}
+
+		/** @return widget context type for net id, @PathName resolves types sharing the same id */
+		const UScriptStruct* FindType(uint32 TypeId, const FString* PathName)
+		{
+			if (PathName != nullptr)
+			{
+				const UScriptStruct* ContextType = FindObject<UScriptStruct>(nullptr, **PathName);
+				return ContextType && Register(ContextType) == TypeId ? ContextType : nullptr;
+			}
+			
+			RegisterLoadedTypes(false);
+			if (!TypesById.Contains(TypeId))
+			{
+				// context type may come from a module loaded after the last lookup
+				RegisterLoadedTypes(true);
+			}
+
+			const FTypeList* Types = TypesById.Find(TypeId);
+			if (Types && Types->Num() > 1)
+			{
+				UE_LOG(LogHUDFramework, Error, TEXT("%s: widget context net type id %u is shared by %d types, sender didn't provide type path"), *FString(__FUNCTION__), TypeId, Types->Num());
+				return nullptr;
+			}
+			return Types ? (*Types)[0] : nullptr;
+		}
+
+	private:
+		using FTypeList = TArray<const UScriptStruct*, TInlineAllocator<1>>;
+
+		static uint32 MakeTypeId(const FString& PathName)
+		{
+			// 0 is reserved for an invalid context
+			const uint32 TypeId = FCrc::StrCrc32(*PathName);
+			return TypeId != 0 ? TypeId : 1;
+		}
+
+		uint32 Register(const UScriptStruct* ContextType)
+		{
+			if (const uint32* TypeId = TypeIds.Find(ContextType))
+			{
+				return *TypeId;
+			}
+			
+			if (ContextType == nullptr || !ContextType->IsChildOf(FHUDWidgetContextBase::StaticStruct()))
+			{
+				return 0;
+			}
+
+			const uint32 TypeId = MakeTypeId(ContextType->GetPathName());
+			TypeIds.Add(ContextType, TypeId);
+			TypesById.FindOrAdd(TypeId).Add(ContextType);
+			return TypeId;
+		}
+
+		/** register currently loaded context types, so types sharing an id are known before the first id is sent */
+		void RegisterLoadedTypes(bool bForce)
+		{
+			if (bInitialized && !bForce)
+			{
+				return;
+			}
+			bInitialized = true;
+
+			const UScriptStruct* BaseType = FHUDWidgetContextBase::StaticStruct();
+			for (TObjectIterator<UScriptStruct> It; It; ++It)
+			{
+				if (It->IsChildOf(BaseType))
+				{
+					Register(*It);
+				}
+			}
+		}
+
+		TMap<uint32, FTypeList> TypesById;
+		TMap<const UScriptStruct*, uint32> TypeIds;
+		bool bInitialized = false;
+	};
+}
+
 FHUDWidgetContextHandle::FHUDWidgetContextHandle(const UScriptStruct* ScriptStruct, const void* StructMemory)
 {
 	check(ScriptStruct);
+	LLM_SCOPE_BYTAG(HUDFramework_WidgetContexts);
 
 	ContextType = ScriptStruct;
 	void* ContextMemory = FMemory::Malloc(FMath::Max(1, ContextType->GetStructureSize()), ContextType->GetMinAlignment());
@@ -11,6 +128,198 @@ FHUDWidgetContextHandle::FHUDWidgetContextHandle(const UScriptStruct* ScriptStru
 	{
 		ContextType->CopyScriptStruct(ContextMemory, StructMemory);
 	}
+
+	// memory is allocated for a script struct, destroy it the same way
+	ContextData = TSharedPtr<FHUDWidgetContextProxy>(static_cast<FHUDWidgetContextProxy*>(ContextMemory), [ScriptStruct](FHUDWidgetContextProxy* Context)
+	{
+		ScriptStruct->DestroyStruct(Context);
+		FMemory::Free(Context);
+	});
+}
+
+bool FHUDWidgetContextHandle::Identical(const FHUDWidgetContextHandle* Other, uint32 PortFlags) const
+{
+	if (Other == nullptr)
+	{
+		return false;
+	}
+
+	if (ContextData.Get() == Other->ContextData.Get())
+	{
+		return true;
+	}
+
+	if (!IsValid() || !Other->IsValid() || !IsA(Other->GetContextType()))
+	{
+		return false;
+	}
+
+	return ContextType->CompareScriptStruct(ContextData.Get(), Other->ContextData.Get(), PortFlags);
+}
+
+bool FHUDWidgetContextHandle::Serialize(FArchive& Ar)
+{
+	UScriptStruct* ScriptStruct = const_cast<UScriptStruct*>(ContextType.Get());
+	Ar << ScriptStruct;
+
+	if (Ar.IsLoading())
+	{
+		if (ScriptStruct == nullptr || !ScriptStruct->IsChildOf(FHUDWidgetContextBase::StaticStruct()))
+		{
+			Invalidate();
+		}
+		else if (!IsA(ScriptStruct) || !ContextData.IsUnique())
+		{
+			*this = FHUDWidgetContextHandle{ScriptStruct, nullptr};
+		}
+	}
+
+	// serialized size allows to skip context data if context type was removed
+	int32 SerialSize = 0;
+	if (Ar.IsLoading())
+	{
+		Ar << SerialSize;
+		if (IsValid())
+		{
+			ScriptStruct->SerializeItem(Ar, ContextData.Get(), nullptr);
+		}
+		else if (SerialSize > 0)
+		{
+			UE_LOG(LogHUDFramework, Warning, TEXT("%s: failed to load widget context type, skipping context data"), *FString(__FUNCTION__));
+			Ar.Seek(Ar.Tell() + SerialSize);
+		}
+		else if (SerialSize == INDEX_NONE)
+		{
+			UE_LOG(LogHUDFramework, Error, TEXT("%s: failed to load widget context type, context data of unknown size can't be skipped"), *FString(__FUNCTION__));
+			Ar.SetError();
+		}
+	}
+	else if (Ar.IsSaving())
+	{
+		// archives without seek support can't patch the size, mark it as unknown
+		const int64 SizeOffset = Ar.Tell();
+		SerialSize = SizeOffset != INDEX_NONE ? 0 : INDEX_NONE;
+		Ar << SerialSize;
+
+		const int64 InitialOffset = Ar.Tell();
+		if (IsValid())
+		{
+			ScriptStruct->SerializeItem(Ar, ContextData.Get(), nullptr);
+		}
+		const int64 FinalOffset = Ar.Tell();
+
+		// patch serialized size now that context data is written
+		if (SizeOffset != INDEX_NONE)
+		{
+			Ar.Seek(SizeOffset);
+			SerialSize = static_cast<int32>(FinalOffset - InitialOffset);
+			Ar << SerialSize;
+			Ar.Seek(FinalOffset);
+		}
+	}
+	else if (IsValid())
+	{
+		// reference collection and other non-persistent archives
+		ScriptStruct->SerializeItem(Ar, ContextData.Get(), nullptr);
+	}
+
+	return true;
+}
+
+bool FHUDWidgetContextHandle::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	HUDWidgetContext::FTypeRegistry& Registry = HUDWidgetContext::FTypeRegistry::Get();
+
+	uint32 TypeId = 0;
+	uint8 bHasContext = 0;
+	uint8 bHasPath = 0;
+	FString PathName;
+	if (Ar.IsSaving() && IsValid())
+	{
+		bool bSendPath = false;
+		TypeId = Registry.GetTypeId(ContextType.Get(), bSendPath);
+		if (TypeId == 0)
+		{
+			UE_LOG(LogHUDFramework, Error, TEXT("%s: failed to find net type id for widget context %s"), *FString(__FUNCTION__), *ContextType->GetName());
+		}
+		
+		bHasContext = TypeId != 0;
+		bHasPath = bSendPath;
+		if (bHasPath)
+		{
+			PathName = ContextType->GetPathName();
+		}
+	}
 	
-	ContextData = MakeShareable<FHUDWidgetContextProxy>(static_cast<FHUDWidgetContextProxy*>(ContextMemory));
+	Ar.SerializeBits(&bHasContext, 1);
+	if (bHasContext)
+	{
+		Ar << TypeId;
+		Ar.SerializeBits(&bHasPath, 1);
+		if (bHasPath)
+		{
+			Ar << PathName;
+		}
+	}
+
+	if (Ar.IsLoading())
+	{
+		const UScriptStruct* ScriptStruct = bHasContext ? Registry.FindType(TypeId, bHasPath ? &PathName : nullptr) : nullptr;
+		if (bHasContext && ScriptStruct == nullptr)
+		{
+			UE_LOG(LogHUDFramework, Error, TEXT("%s: failed to resolve widget context net type id %u %s"), *FString(__FUNCTION__), TypeId, *PathName);
+
+			Invalidate();
+			bOutSuccess = false;
+			return true;
+		}
+
+		if (ScriptStruct == nullptr)
+		{
+			Invalidate();
+		}
+		else if (!IsA(ScriptStruct) || !ContextData.IsUnique())
+		{
+			// reuse context memory if it is not shared with anyone else, otherwise allocate a new context
+			*this = FHUDWidgetContextHandle{ScriptStruct, nullptr};
+		}
+	}
+
+	bOutSuccess = !bHasContext || NetSerializeContextData(Ar, Map);
+	return true;
+}
+
+bool FHUDWidgetContextHandle::NetSerializeContextData(FArchive& Ar, UPackageMap* Map)
+{
+	UScriptStruct* ScriptStruct = const_cast<UScriptStruct*>(ContextType.Get());
+	void* ContextMemory = ContextData.Get();
+	check(ScriptStruct && ContextMemory);
+
+	if (ScriptStruct->StructFlags & STRUCT_NetSerializeNative)
+	{
+		bool bSuccess = true;
+		ScriptStruct->GetCppStructOps()->NetSerialize(Ar, Map, bSuccess, ContextMemory);
+		return bSuccess;
+	}
+
+	// serialize replicated properties using struct rep layout
+	UPackageMapClient* PackageMapClient = Cast<UPackageMapClient>(Map);
+	if (PackageMapClient && PackageMapClient->GetConnection() && PackageMapClient->GetConnection()->Driver)
+	{
+		TSharedPtr<FRepLayout> RepLayout = PackageMapClient->GetConnection()->Driver->GetStructRepLayout(ScriptStruct);
+		if (RepLayout.IsValid())
+		{
+			bool bHasUnmapped = false;
+			RepLayout->SerializePropertiesForStruct(ScriptStruct, static_cast<FBitArchive&>(Ar), Map, ContextMemory, bHasUnmapped);
+			if (bHasUnmapped)
+			{
+				// package map tracks unmapped guids for the owning property, it is received again once they are mapped
+				UE_LOG(LogHUDFramework, Verbose, TEXT("%s: widget context %s has unmapped object references"), *FString(__FUNCTION__), *ScriptStruct->GetName());
+			}
+			return !Ar.IsError();
+		}
+	}
+
+	UE_LOG(LogHUDFramework, Error, TEXT("%s: failed to net serialize widget context %s"), *FString(__FUNCTION__), *ScriptStruct->GetName());
+	return false;
 }
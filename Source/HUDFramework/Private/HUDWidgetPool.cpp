@@ -2,6 +2,17 @@
 
 #include "HUDWidgetPool.h"
 
+#include "HUDFramework.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool Acquire"),	STAT_HUD_Framework_PoolAcquire,	STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool Release"),	STAT_HUD_Framework_PoolRelease,	STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool Miss"),		STAT_HUD_Framework_PoolMiss,	STATGROUP_HUD_Framework);
+
+TRACE_DECLARE_INT_COUNTER(HUDFramework_PoolAcquire,	TEXT("HUDFramework/PoolAcquire"));
+TRACE_DECLARE_INT_COUNTER(HUDFramework_PoolRelease,	TEXT("HUDFramework/PoolRelease"));
+TRACE_DECLARE_INT_COUNTER(HUDFramework_PoolMiss,	TEXT("HUDFramework/PoolMiss"));
+
 FHUDWidgetPool::FHUDWidgetPool(UWidget& InOwningWidget)
 	: OwningWidget(&InOwningWidget)
 {}
@@ -35,6 +46,48 @@ void FHUDWidgetPool::AddReferencedObjects(FReferenceCollector& Collector)
 	Collector.AddReferencedObjects<UUserWidget>(InactiveWidgets, OwningWidget.Get());
 }
 
+UUserWidget* FHUDWidgetPool::AcquireWidgetInstance(TSubclassOf<UUserWidget> WidgetClass)
+{
+	LLM_SCOPE_BYTAG(HUDFramework_WidgetPool_Objects);
+	INC_DWORD_STAT(STAT_HUD_Framework_PoolAcquire);
+	TRACE_COUNTER_INCREMENT(HUDFramework_PoolAcquire);
+	
+	for (UUserWidget* InactiveWidget : InactiveWidgets)
+	{
+		if (InactiveWidget->GetClass() == WidgetClass)
+		{
+			InactiveWidgets.RemoveSingleSwap(InactiveWidget);
+			return InactiveWidget;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_HUD_Framework_PoolMiss);
+	TRACE_COUNTER_INCREMENT(HUDFramework_PoolMiss);
+	// per class event, so pool misses can be attributed to widget classes
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(*FString::Printf(TEXT("PoolMiss %s"), *WidgetClass->GetName()), HUDFrameworkChannel);
+	
+	if (UWidget* OwningWidgetPtr = OwningWidget.Get())
+	{
+		return CreateWidget(OwningWidgetPtr, WidgetClass);
+	}
+	if (APlayerController* PlayerControllerPtr = DefaultPlayerController.Get())
+	{
+		return CreateWidget(PlayerControllerPtr, WidgetClass);
+	}
+	return CreateWidget(OwningWorld.Get(), WidgetClass);
+}
+
+void FHUDWidgetPool::TakeSlateWidget(UUserWidget* WidgetInstance, WidgetConstructFunc ConstructWidgetFunc)
+{
+	LLM_SCOPE_BYTAG(HUDFramework_WidgetPool_Slate);
+	
+	TSharedPtr<SWidget>& CachedSlateWidget = CachedSlateByWidgetObject.FindOrAdd(WidgetInstance);
+	if (!CachedSlateWidget.IsValid())
+	{
+		CachedSlateWidget = WidgetInstance->TakeDerivedWidget(ConstructWidgetFunc);
+	}
+}
+
 void FHUDWidgetPool::Release(UUserWidget* Widget)
 {
 	if (Widget != nullptr)
@@ -42,6 +95,9 @@ void FHUDWidgetPool::Release(UUserWidget* Widget)
 		const int32 ActiveWidgetIdx = ActiveWidgets.Find(Widget);
 		if (ActiveWidgetIdx != INDEX_NONE)
 		{
+			INC_DWORD_STAT(STAT_HUD_Framework_PoolRelease);
+			TRACE_COUNTER_INCREMENT(HUDFramework_PoolRelease);
+			
 			InactiveWidgets.Push(Widget);
 			ActiveWidgets.RemoveAt(ActiveWidgetIdx);
 
@@ -60,6 +116,9 @@ void FHUDWidgetPool::Release(TConstArrayView<UUserWidget*> Widgets)
 
 void FHUDWidgetPool::ReleaseAll()
 {
+	INC_DWORD_STAT_BY(STAT_HUD_Framework_PoolRelease, ActiveWidgets.Num());
+	TRACE_COUNTER_ADD(HUDFramework_PoolRelease, ActiveWidgets.Num());
+	
 	InactiveWidgets.Append(ActiveWidgets);
 	ActiveWidgets.Empty();
 
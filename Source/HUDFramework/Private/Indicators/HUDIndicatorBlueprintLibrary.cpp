@@ -30,14 +30,36 @@ void UHUDIndicatorBlueprintLibrary::AddIndicator_ActorWithContext(const UHUDIndi
 {
 	GET_INDICATOR_MANAGER_OR_RETURN(OwnerActor);
 
-	IndicatorManager->AddIndicatorWithContext(Descriptor, OwnerActor, FHUDWidgetContextHandle::CreateContext<FIndicatorWidgetContext>(ContextObject, Descriptor));
+	IndicatorManager->AddIndicatorWithContext(Descriptor, OwnerActor, IndicatorManager->CreateWidgetContext(ContextObject, Descriptor));
 }
 
 void UHUDIndicatorBlueprintLibrary::AddIndicator_ComponentWithContext(const UHUDIndicatorDescriptor* Descriptor, const USceneComponent* Component, FName SocketName, UObject* ContextObject)
 {
 	GET_INDICATOR_MANAGER_OR_RETURN(Component);
 
-	IndicatorManager->AddIndicatorWithContext(Descriptor, Component, SocketName, FHUDWidgetContextHandle::CreateContext<FIndicatorWidgetContext>(ContextObject, Descriptor));
+	IndicatorManager->AddIndicatorWithContext(Descriptor, Component, SocketName, IndicatorManager->CreateWidgetContext(ContextObject, Descriptor));
+}
+
+void UHUDIndicatorBlueprintLibrary::AddIndicators_Actors(const UHUDIndicatorDescriptor* Descriptor, const TArray<AActor*>& OwnerActors)
+{
+	if (OwnerActors.IsEmpty())
+	{
+		return;
+	}
+	GET_INDICATOR_MANAGER_OR_RETURN(OwnerActors[0]);
+
+	IndicatorManager->AddIndicators(Descriptor, OwnerActors);
+}
+
+void UHUDIndicatorBlueprintLibrary::AddIndicators_Components(const UHUDIndicatorDescriptor* Descriptor, const TArray<USceneComponent*>& Components, FName SocketName)
+{
+	if (Components.IsEmpty())
+	{
+		return;
+	}
+	GET_INDICATOR_MANAGER_OR_RETURN(Components[0]);
+
+	IndicatorManager->AddIndicators(Descriptor, Components, SocketName);
 }
 
 void UHUDIndicatorBlueprintLibrary::RemoveIndicator_Actor(const AActor* OwnerActor)
@@ -54,4 +76,52 @@ void UHUDIndicatorBlueprintLibrary::RemoveIndicator_Component(const USceneCompon
 	IndicatorManager->RemoveIndicators(Component);
 }
 
+void UHUDIndicatorBlueprintLibrary::RemoveIndicators_Actors(const TArray<AActor*>& OwnerActors)
+{
+	if (OwnerActors.IsEmpty())
+	{
+		return;
+	}
+	GET_INDICATOR_MANAGER_OR_RETURN(OwnerActors[0]);
+
+	IndicatorManager->RemoveIndicators(OwnerActors);
+}
+
+void UHUDIndicatorBlueprintLibrary::RemoveIndicators_Components(const TArray<USceneComponent*>& Components)
+{
+	if (Components.IsEmpty())
+	{
+		return;
+	}
+	GET_INDICATOR_MANAGER_OR_RETURN(Components[0]);
+
+	IndicatorManager->RemoveIndicators(Components);
+}
+
+FHUDIndicatorHandle UHUDIndicatorBlueprintLibrary::AddIndicator_Location(const UObject* WorldContextObject, const UHUDIndicatorDescriptor* Descriptor, FVector WorldLocation, UObject* ContextObject)
+{
+	UHUDIndicatorManagerComponent* IndicatorManager = UHUDIndicatorManagerComponent::Get(WorldContextObject);
+	if (!IsValid(IndicatorManager))
+	{
+		UE_LOG(LogIndicators, Error, TEXT("%s: Failed to find indicator manager for context %s"), *FString(__FUNCTION__), *GetNameSafe(WorldContextObject));
+		return {};
+	}
+
+	return IndicatorManager->AddIndicatorAtLocation(Descriptor, WorldLocation, IndicatorManager->CreateWidgetContext(ContextObject, Descriptor));
+}
+
+void UHUDIndicatorBlueprintLibrary::SetIndicatorLocation(const UObject* WorldContextObject, FHUDIndicatorHandle Handle, FVector WorldLocation)
+{
+	GET_INDICATOR_MANAGER_OR_RETURN(WorldContextObject);
+
+	IndicatorManager->SetIndicatorLocation(Handle, WorldLocation);
+}
+
+void UHUDIndicatorBlueprintLibrary::RemoveIndicator_Handle(const UObject* WorldContextObject, FHUDIndicatorHandle Handle)
+{
+	GET_INDICATOR_MANAGER_OR_RETURN(WorldContextObject);
+
+	IndicatorManager->RemoveIndicator(Handle);
+}
+
 #undef GET_INDICATOR_MANAGER_OR_RETURN
\ No newline at end of file
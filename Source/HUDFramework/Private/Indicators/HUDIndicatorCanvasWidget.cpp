@@ -29,7 +29,8 @@ TSharedRef<SWidget> UHUDIndicatorCanvasWidget::RebuildWidget()
 	
 	if (ensureAlwaysMsgf(LocalPlayer != nullptr, TEXT("%s: Attempt to rebuild with invalid LocalPlayer!"), *FString(__FUNCTION__)))
 	{
-		IndicatorCanvas = SNew(SIndicatorCanvas, FLocalPlayerContext(LocalPlayer), CategoryTags, &ArrowBrush);
+		IndicatorCanvas = SNew(SIndicatorCanvas, FLocalPlayerContext(LocalPlayer), CategoryTags, &ArrowBrush)
+			.Settings(CanvasSettings);
 		IndicatorCanvas->SetWidgetPool(&WidgetPool);
 		return IndicatorCanvas.ToSharedRef();
 	}
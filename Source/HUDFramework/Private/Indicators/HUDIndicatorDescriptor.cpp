@@ -1 +1,115 @@
 ﻿#include "Indicators/HUDIndicatorDescriptor.h"
+
+#include "Curves/CurveFloat.h"
+
+namespace HUDIndicatorDescriptor
+{
+	/** @return fraction of indicator size that lies before its screen position */
+	float GetAlignmentFactor(EHorizontalAlignment Alignment)
+	{
+		switch (Alignment)
+		{
+		case HAlign_Left:	return 0.f;
+		case HAlign_Right:	return 1.f;
+		default:			return 0.5f;
+		}
+	}
+
+	float GetAlignmentFactor(EVerticalAlignment Alignment)
+	{
+		switch (Alignment)
+		{
+		case VAlign_Top:	return 0.f;
+		case VAlign_Bottom:	return 1.f;
+		default:			return 0.5f;
+		}
+	}
+}
+
+void UHUDIndicatorDescriptor::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+#if WITH_EDITOR
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &ThisClass::HandleObjectPropertyChanged);
+	}
+#endif
+	
+	BuildRuntimeData();
+}
+
+void UHUDIndicatorDescriptor::PostLoad()
+{
+	Super::PostLoad();
+
+	BuildRuntimeData();
+}
+
+void UHUDIndicatorDescriptor::BeginDestroy()
+{
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+	ObjectPropertyChangedHandle.Reset();
+#endif
+	
+	Super::BeginDestroy();
+}
+
+#if WITH_EDITOR
+void UHUDIndicatorDescriptor::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	BuildRuntimeData();
+}
+
+void UHUDIndicatorDescriptor::HandleObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	if (bEnableScaling && Object != nullptr && Object == ScaleCurve)
+	{
+		BuildRuntimeData();
+	}
+}
+#endif
+
+void UHUDIndicatorDescriptor::BuildRuntimeData()
+{
+	RuntimeData = FHUDIndicatorDescriptorRuntimeData{};
+	
+	RuntimeData.Alignment = FVector2f{
+		HUDIndicatorDescriptor::GetAlignmentFactor(HorizontalAlignment),
+		HUDIndicatorDescriptor::GetAlignmentFactor(VerticalAlignment)
+	};
+	RuntimeData.MaxDistance = MaxDistance;
+	RuntimeData.OccludedOpacity = OccludedOpacity;
+	RuntimeData.Priority = Priority;
+	RuntimeData.OcclusionMode = OcclusionMode;
+
+	EHUDIndicatorDescriptorFlags& Flags = RuntimeData.Flags;
+	Flags |= bClampToScreen ? EHUDIndicatorDescriptorFlags::ClampToScreen : EHUDIndicatorDescriptorFlags::None;
+	Flags |= bShowClampToScreenArrow ? EHUDIndicatorDescriptorFlags::ShowClampToScreenArrow : EHUDIndicatorDescriptorFlags::None;
+	Flags |= bOverrideArrowBrush ? EHUDIndicatorDescriptorFlags::OverrideArrowBrush : EHUDIndicatorDescriptorFlags::None;
+	Flags |= bDisplayIndicatorWhenComponentCanNotRender ? EHUDIndicatorDescriptorFlags::DisplayWhenCannotRender : EHUDIndicatorDescriptorFlags::None;
+
+	if (bEnableScaling && ScaleCurve != nullptr)
+	{
+		// curve keys are used below, make sure they are loaded
+		ScaleCurve->ConditionalPostLoad();
+		
+		float MinDepth = 0.f, MaxDepth = 0.f;
+		ScaleCurve->GetTimeRange(MinDepth, MaxDepth);
+
+		// scale is constant outside of the curve time range
+		const float DepthStep = FMath::Max((MaxDepth - MinDepth) / (FHUDIndicatorDescriptorRuntimeData::ScaleLUTSize - 1), UE_KINDA_SMALL_NUMBER);
+		for (int32 Index = 0; Index < FHUDIndicatorDescriptorRuntimeData::ScaleLUTSize; ++Index)
+		{
+			RuntimeData.ScaleLUT[Index] = ScaleCurve->GetFloatValue(MinDepth + DepthStep * Index);
+		}
+		RuntimeData.MinDepth = MinDepth;
+		RuntimeData.InvDepthStep = 1.f / DepthStep;
+		
+		Flags |= EHUDIndicatorDescriptorFlags::EnableScaling;
+	}
+}
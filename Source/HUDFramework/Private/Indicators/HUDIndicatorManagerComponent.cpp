@@ -1,11 +1,134 @@
 ﻿#include "Indicators/HUDIndicatorManagerComponent.h"
 
 #include "HUDFramework.h"
-#include "Indicators/HUDIndicatorBlueprintLibrary.h"
+#include "Indicators/HUDIndicatorTypes.h"
 #include "Indicators/HUDIndicatorDescriptor.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "Net/UnrealNetwork.h"
+
+namespace HUDIndicatorManager
+{
+	template <typename TKeyType, typename TListType, typename TValueType>
+	void RemoveFromIndex(TMap<TKeyType, TListType>& Index, const TKeyType& Key, const TValueType& Value)
+	{
+		if (TListType* List = Index.Find(Key))
+		{
+			List->RemoveSingleSwap(Value);
+			if (List->IsEmpty())
+			{
+				Index.Remove(Key);
+			}
+		}
+	}
+
+	/** call @Func for each run of indicators of the same category. Indicators added in bursts usually share a category */
+	template <typename TFunc>
+	void ForEachCategoryRun(TConstArrayView<TSharedRef<FIndicatorDescriptorInstance>> Instances, TFunc&& Func)
+	{
+		int32 RunStart = 0;
+		for (int32 Index = 1; Index <= Instances.Num(); ++Index)
+		{
+			if (Index == Instances.Num() || Instances[Index]->CategoryTag != Instances[RunStart]->CategoryTag)
+			{
+				Func(Instances[RunStart]->CategoryTag, Instances.Slice(RunStart, Index - RunStart));
+				RunStart = Index;
+			}
+		}
+	}
+}
+
+void FHUDReplicatedIndicatorList::PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize)
+{
+	for (const int32 Index: RemovedIndices)
+	{
+		FHUDReplicatedIndicator& Entry = Items[Index];
+		if (Entry.Instance.IsValid())
+		{
+			Owner->RemoveIndicatorInternal(Entry.Instance.ToSharedRef());
+			PendingRemoved.Add(Entry.Instance.ToSharedRef());
+			Entry.Instance.Reset();
+		}
+	}
+}
+
+void FHUDReplicatedIndicatorList::PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize)
+{
+	for (const int32 Index: AddedIndices)
+	{
+		FHUDReplicatedIndicator& Entry = Items[Index];
+		// entries with unmapped targets are created when their target is mapped, see PostReplicatedChange
+		Entry.Instance = Owner->CreateReplicatedInstance(Entry);
+		if (Entry.Instance.IsValid())
+		{
+			PendingAdded.Add(Entry.Instance.ToSharedRef());
+		}
+	}
+}
+
+void FHUDReplicatedIndicatorList::PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize)
+{
+	for (const int32 Index: ChangedIndices)
+	{
+		FHUDReplicatedIndicator& Entry = Items[Index];
+		if (Entry.Instance.IsValid())
+		{
+			FIndicatorDescriptorInstance& Instance = *Entry.Instance;
+			if (Entry.bPositional && Instance.IsPositional() && Entry.Descriptor == Instance.Descriptor)
+			{
+				// moved positional indicator, canvases read location every frame
+				Instance.WorldLocation = Entry.WorldLocation;
+				continue;
+			}
+			
+			Owner->RemoveIndicatorInternal(Entry.Instance.ToSharedRef());
+			PendingRemoved.Add(Entry.Instance.ToSharedRef());
+			Entry.Instance.Reset();
+		}
+
+		Entry.Instance = Owner->CreateReplicatedInstance(Entry);
+		if (Entry.Instance.IsValid())
+		{
+			PendingAdded.Add(Entry.Instance.ToSharedRef());
+		}
+	}
+}
+
+void FHUDReplicatedIndicatorList::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	// apply the whole replication update to canvases at once
+	if (!PendingRemoved.IsEmpty())
+	{
+		Owner->BroadcastIndicatorsRemoved(PendingRemoved);
+		PendingRemoved.Reset();
+	}
+	if (!PendingAdded.IsEmpty())
+	{
+		Owner->BroadcastIndicatorsAdded(PendingAdded);
+		PendingAdded.Reset();
+	}
+}
 
 UHUDIndicatorManagerComponent::UHUDIndicatorManagerComponent(const FObjectInitializer& Initializer) : Super(Initializer)
 {
+	ReplicatedIndicators.Owner = this;
+}
+
+void UHUDIndicatorManagerComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UHUDIndicatorManagerComponent, ReplicatedIndicators);
+}
+
+void UHUDIndicatorManagerComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	if (bReplicateIndicators && !GetIsReplicated())
+	{
+		SetIsReplicated(true);
+	}
 }
 
 void UHUDIndicatorManagerComponent::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
@@ -27,16 +150,42 @@ void UHUDIndicatorManagerComponent::OnUnregister()
 {
 	Super::OnUnregister();
 
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(StaleIndicatorSweepTimer);
+	}
+
+	TArray<TSharedRef<FIndicatorDescriptorInstance>> Instances;
+	Instances.Reserve(IndicatorInstances.Num());
 	for (const TSharedPtr<FIndicatorDescriptorInstance>& Instance : IndicatorInstances)
 	{
-		OnIndicatorRemoved.Broadcast(Instance.ToSharedRef());
-		// Dont remove indicators in range-based for
+		Instances.Add(Instance.ToSharedRef());
 	}
 
 	IndicatorInstances.Empty();
+	IndicatorsByActor.Empty();
+	IndicatorsByComponent.Empty();
+	IndicatorsByHandle.Empty();
+	for (FHUDReplicatedIndicator& Entry: ReplicatedIndicators.Items)
+	{
+		Entry.Instance.Reset();
+	}
+	ReplicatedIndicators.PendingAdded.Empty();
+	ReplicatedIndicators.PendingRemoved.Empty();
+	for (auto& [CategoryTag, Category]: Categories)
+	{
+		Category.Indicators.Empty();
+	}
+	ContextArena.Reset();
+
+	if (!Instances.IsEmpty())
+	{
+		BroadcastIndicatorsRemoved(Instances);
+	}
 
-	OnIndicatorAdded.Clear();
-	OnIndicatorRemoved.Clear();
+	OnIndicatorsAdded.Clear();
+	OnIndicatorsRemoved.Clear();
+	Categories.Empty();
 }
 
 UHUDIndicatorManagerComponent* UHUDIndicatorManagerComponent::Get(const UObject* WorldContextObject)
@@ -51,16 +200,97 @@ UHUDIndicatorManagerComponent* UHUDIndicatorManagerComponent::Get(const UObject*
 	return IsValid(GameState) ? GameState->FindComponentByClass<UHUDIndicatorManagerComponent>(): nullptr;
 }
 
+FIndicatorListDelegate& UHUDIndicatorManagerComponent::OnCategoryIndicatorsAdded(FGameplayTag CategoryTag)
+{
+	return Categories.FindOrAdd(CategoryTag).OnIndicatorsAdded;
+}
+
+FIndicatorListDelegate& UHUDIndicatorManagerComponent::OnCategoryIndicatorsRemoved(FGameplayTag CategoryTag)
+{
+	return Categories.FindOrAdd(CategoryTag).OnIndicatorsRemoved;
+}
+
+const TSet<TSharedPtr<FIndicatorDescriptorInstance>>& UHUDIndicatorManagerComponent::GetIndicators(FGameplayTag CategoryTag) const
+{
+	static const TSet<TSharedPtr<FIndicatorDescriptorInstance>> EmptyIndicators;
+	
+	const FIndicatorCategory* Category = Categories.Find(CategoryTag);
+	return Category ? Category->Indicators : EmptyIndicators;
+}
+
+FHUDWidgetContextHandle UHUDIndicatorManagerComponent::CreateWidgetContext(UObject* ContextObject, const UHUDIndicatorDescriptor* Descriptor)
+{
+	return ContextArena.CreateContext(ContextObject, Descriptor);
+}
+
 void UHUDIndicatorManagerComponent::AddIndicator(const UHUDIndicatorDescriptor* Descriptor, const AActor* OwnerActor)
 {
 	// create context anyway with Descriptor as a data object
-	AddIndicatorWithContext(Descriptor, OwnerActor, FHUDWidgetContextHandle::CreateContext<FIndicatorWidgetContext>(nullptr, Descriptor));
+	AddIndicatorWithContext(Descriptor, OwnerActor, CreateWidgetContext(nullptr, Descriptor));
 }
 
 void UHUDIndicatorManagerComponent::AddIndicator(const UHUDIndicatorDescriptor* Descriptor, const USceneComponent* Component, FName SocketName)
 {
 	// create context anyway with Descriptor as a data object
-	AddIndicatorWithContext(Descriptor, Component, SocketName, FHUDWidgetContextHandle::CreateContext<FIndicatorWidgetContext>(nullptr, Descriptor));
+	AddIndicatorWithContext(Descriptor, Component, SocketName, CreateWidgetContext(nullptr, Descriptor));
+}
+
+void UHUDIndicatorManagerComponent::AddIndicators(const UHUDIndicatorDescriptor* Descriptor, TConstArrayView<const AActor*> OwnerActors)
+{
+	if (Descriptor == nullptr)
+	{
+		UE_LOG(LogIndicators, Error, TEXT("%s: Failed to add indicators for %d actors, descriptor is null"), *FString(__FUNCTION__), OwnerActors.Num());
+		return;
+	}
+
+	TArray<TSharedRef<FIndicatorDescriptorInstance>> NewInstances;
+	NewInstances.Reserve(OwnerActors.Num());
+	for (const AActor* OwnerActor: OwnerActors)
+	{
+		if (!IsValid(OwnerActor))
+		{
+			UE_LOG(LogIndicators, Error, TEXT("%s: Failed to add indicator with [%s] descriptor for [%s] actor"), *FString(__FUNCTION__), *GetNameSafe(Descriptor), *GetNameSafe(OwnerActor));
+			continue;
+		}
+
+		const TSharedRef<FIndicatorDescriptorInstance>& NewInstance = NewInstances.Add_GetRef(MakeShared<FIndicatorDescriptorInstance>(Descriptor, OwnerActor->GetRootComponent(), NAME_None, CreateWidgetContext(nullptr, Descriptor)));
+		NewInstance->OwnerKey = OwnerActor;
+		AddIndicatorInternal(NewInstance);
+	}
+
+	if (!NewInstances.IsEmpty())
+	{
+		BroadcastIndicatorsAdded(NewInstances);
+	}
+}
+
+void UHUDIndicatorManagerComponent::AddIndicators(const UHUDIndicatorDescriptor* Descriptor, TConstArrayView<const USceneComponent*> Components, FName SocketName)
+{
+	if (Descriptor == nullptr)
+	{
+		UE_LOG(LogIndicators, Error, TEXT("%s: Failed to add indicators for %d components, descriptor is null"), *FString(__FUNCTION__), Components.Num());
+		return;
+	}
+
+	TArray<TSharedRef<FIndicatorDescriptorInstance>> NewInstances;
+	NewInstances.Reserve(Components.Num());
+	for (const USceneComponent* Component: Components)
+	{
+		if (!IsValid(Component))
+		{
+			UE_LOG(LogIndicators, Error, TEXT("%s: Failed to add indicator with [%s] descriptor for [%s] component"), *FString(__FUNCTION__), *GetNameSafe(Descriptor), *GetNameSafe(Component));
+			continue;
+		}
+
+		const TSharedRef<FIndicatorDescriptorInstance>& NewInstance = NewInstances.Add_GetRef(MakeShared<FIndicatorDescriptorInstance>(Descriptor, Component, SocketName, CreateWidgetContext(nullptr, Descriptor)));
+		NewInstance->OwnerKey = Component->GetOwner();
+		AddIndicatorInternal(NewInstance);
+	}
+
+	if (!NewInstances.IsEmpty())
+	{
+		BroadcastIndicatorsAdded(NewInstances);
+	}
 }
 
 void UHUDIndicatorManagerComponent::AddIndicatorWithContext(const UHUDIndicatorDescriptor* Descriptor, const AActor* OwnerActor, const FHUDWidgetContextHandle& WidgetContext)
@@ -71,8 +301,11 @@ void UHUDIndicatorManagerComponent::AddIndicatorWithContext(const UHUDIndicatorD
 		return;
 	}
 
-	const TSharedPtr<FIndicatorDescriptorInstance> NewInstance = MakeShared<FIndicatorDescriptorInstance>(Descriptor, OwnerActor->GetRootComponent(), NAME_None, WidgetContext);
+	const TSharedRef<FIndicatorDescriptorInstance> NewInstance = MakeShared<FIndicatorDescriptorInstance>(Descriptor, OwnerActor->GetRootComponent(), NAME_None, WidgetContext);
+	NewInstance->OwnerKey = OwnerActor;
 	AddIndicatorInternal(NewInstance);
+
+	BroadcastIndicatorsAdded(MakeArrayView(&NewInstance, 1));
 }
 
 
@@ -84,40 +317,511 @@ void UHUDIndicatorManagerComponent::AddIndicatorWithContext(const UHUDIndicatorD
 		return;
 	}
 
-	const TSharedPtr<FIndicatorDescriptorInstance> NewInstance = MakeShared<FIndicatorDescriptorInstance>(Descriptor, Component, SocketName, WidgetContext);
+	const TSharedRef<FIndicatorDescriptorInstance> NewInstance = MakeShared<FIndicatorDescriptorInstance>(Descriptor, Component, SocketName, WidgetContext);
+	NewInstance->OwnerKey = Component->GetOwner();
 	AddIndicatorInternal(NewInstance);
+
+	BroadcastIndicatorsAdded(MakeArrayView(&NewInstance, 1));
 }
 
-void UHUDIndicatorManagerComponent::AddIndicatorInternal(TSharedPtr<FIndicatorDescriptorInstance> Instance)
+void UHUDIndicatorManagerComponent::AddIndicatorInternal(const TSharedRef<FIndicatorDescriptorInstance>& Instance)
 {
 	check(!IndicatorInstances.Contains(Instance));
-	
+
+	Instance->ComponentKey = Instance->Component.Get();
+	Instance->CategoryTag = Instance->Descriptor->CategoryTag;
 	IndicatorInstances.Add(Instance);
-	OnIndicatorAdded.Broadcast(Instance.ToSharedRef());
+	if (Instance->IsPositional())
+	{
+		IndicatorsByHandle.Add(Instance->Handle, Instance);
+	}
+	else
+	{
+		IndicatorsByActor.FindOrAdd(Instance->OwnerKey).Add(Instance);
+		IndicatorsByComponent.FindOrAdd(Instance->ComponentKey).Add(Instance);
+		StartStaleIndicatorSweep();
+	}
+	Categories.FindOrAdd(Instance->CategoryTag).Indicators.Add(Instance);
 }
 
-void UHUDIndicatorManagerComponent::RemoveIndicators(const AActor* OwnerActor)
+TSharedRef<FIndicatorDescriptorInstance> UHUDIndicatorManagerComponent::AddPositionalIndicatorInternal(const FHUDIndicatorHandle& Handle, const UHUDIndicatorDescriptor* Descriptor, const FHUDWidgetContextHandle& WidgetContext)
+{
+	check(Handle.IsValid());
+	
+	// create context anyway with Descriptor as a data object
+	const TSharedRef<FIndicatorDescriptorInstance> NewInstance = MakeShared<FIndicatorDescriptorInstance>(Descriptor, nullptr, NAME_None,
+		WidgetContext.IsValid() ? WidgetContext : CreateWidgetContext(nullptr, Descriptor));
+
+	NewInstance->Handle = Handle;
+	AddIndicatorInternal(NewInstance);
+
+	return NewInstance;
+}
+
+FHUDIndicatorHandle UHUDIndicatorManagerComponent::AllocateIndicatorHandle(bool bReplicated)
+{
+	uint32& LastHandleId = bReplicated ? LastReplicatedIndicatorHandleId : LastIndicatorHandleId;
+	// zero is reserved for an invalid handle, replicated bit is reserved for handles allocated by server
+	LastHandleId = (LastHandleId + 1) & ~FHUDIndicatorHandle::ReplicatedBit;
+	if (LastHandleId == 0)
+	{
+		++LastHandleId;
+	}
+	
+	return FHUDIndicatorHandle{bReplicated ? LastHandleId | FHUDIndicatorHandle::ReplicatedBit : LastHandleId};
+}
+
+void UHUDIndicatorManagerComponent::RemoveIndicatorInternal(const TSharedRef<FIndicatorDescriptorInstance>& Instance)
 {
-	for (auto It = IndicatorInstances.CreateIterator(); It; ++It)
+	if (Instance->IsPositional())
 	{
-		TSharedPtr<FIndicatorDescriptorInstance> Instance = *It;
-		if (!IsValid(Instance->Component) || OwnerActor == Instance->Component->GetOwner())
+		IndicatorsByHandle.Remove(Instance->Handle);
+	}
+	else
+	{
+		HUDIndicatorManager::RemoveFromIndex(IndicatorsByActor, Instance->OwnerKey, Instance);
+		HUDIndicatorManager::RemoveFromIndex(IndicatorsByComponent, Instance->ComponentKey, Instance);
+	}
+	IndicatorInstances.Remove(Instance);
+	if (FIndicatorCategory* Category = Categories.Find(Instance->CategoryTag))
+	{
+		Category->Indicators.Remove(Instance);
+	}
+}
+
+FHUDIndicatorHandle UHUDIndicatorManagerComponent::AddIndicatorAtLocation(const UHUDIndicatorDescriptor* Descriptor, const FVector& WorldLocation, const FHUDWidgetContextHandle& WidgetContext)
+{
+	if (Descriptor == nullptr)
+	{
+		UE_LOG(LogIndicators, Error, TEXT("%s: Failed to add indicator at [%s], descriptor is null"), *FString(__FUNCTION__), *WorldLocation.ToString());
+		return {};
+	}
+
+	const TSharedRef<FIndicatorDescriptorInstance> NewInstance = AddPositionalIndicatorInternal(AllocateIndicatorHandle(false), Descriptor, WidgetContext);
+	NewInstance->WorldLocation = WorldLocation;
+	
+	BroadcastIndicatorsAdded(MakeArrayView(&NewInstance, 1));
+	return NewInstance->Handle;
+}
+
+FHUDIndicatorHandle UHUDIndicatorManagerComponent::AddIndicatorWithProvider(const UHUDIndicatorDescriptor* Descriptor, const TSharedRef<IHUDIndicatorLocationProvider>& LocationProvider, const FHUDWidgetContextHandle& WidgetContext)
+{
+	if (Descriptor == nullptr)
+	{
+		UE_LOG(LogIndicators, Error, TEXT("%s: Failed to add indicator with location provider, descriptor is null"), *FString(__FUNCTION__));
+		return {};
+	}
+
+	const TSharedRef<FIndicatorDescriptorInstance> NewInstance = AddPositionalIndicatorInternal(AllocateIndicatorHandle(false), Descriptor, WidgetContext);
+	NewInstance->LocationProvider = LocationProvider;
+	
+	BroadcastIndicatorsAdded(MakeArrayView(&NewInstance, 1));
+	return NewInstance->Handle;
+}
+
+void UHUDIndicatorManagerComponent::AddIndicatorsAtLocations(const UHUDIndicatorDescriptor* Descriptor, TConstArrayView<FVector> WorldLocations, TArray<FHUDIndicatorHandle>& OutHandles)
+{
+	if (Descriptor == nullptr)
+	{
+		UE_LOG(LogIndicators, Error, TEXT("%s: Failed to add indicators at %d locations, descriptor is null"), *FString(__FUNCTION__), WorldLocations.Num());
+		return;
+	}
+
+	TArray<TSharedRef<FIndicatorDescriptorInstance>> NewInstances;
+	NewInstances.Reserve(WorldLocations.Num());
+	OutHandles.Reserve(OutHandles.Num() + WorldLocations.Num());
+	for (const FVector& WorldLocation: WorldLocations)
+	{
+		const TSharedRef<FIndicatorDescriptorInstance>& NewInstance = NewInstances.Add_GetRef(AddPositionalIndicatorInternal(AllocateIndicatorHandle(false), Descriptor, {}));
+		NewInstance->WorldLocation = WorldLocation;
+		OutHandles.Add(NewInstance->Handle);
+	}
+
+	if (!NewInstances.IsEmpty())
+	{
+		BroadcastIndicatorsAdded(NewInstances);
+	}
+}
+
+void UHUDIndicatorManagerComponent::SetIndicatorLocation(const FHUDIndicatorHandle& Handle, const FVector& WorldLocation)
+{
+	if (Handle.IsReplicated())
+	{
+		SetReplicatedIndicatorLocation(Handle, WorldLocation);
+		return;
+	}
+	
+	if (const TSharedRef<FIndicatorDescriptorInstance>* Instance = IndicatorsByHandle.Find(Handle))
+	{
+		(*Instance)->WorldLocation = WorldLocation;
+	}
+}
+
+void UHUDIndicatorManagerComponent::RemoveIndicator(const FHUDIndicatorHandle& Handle)
+{
+	RemoveIndicators(MakeArrayView(&Handle, 1));
+}
+
+void UHUDIndicatorManagerComponent::RemoveIndicators(TConstArrayView<FHUDIndicatorHandle> Handles)
+{
+	TArray<TSharedRef<FIndicatorDescriptorInstance>, TInlineAllocator<8>> Instances;
+	for (const FHUDIndicatorHandle& Handle: Handles)
+	{
+		if (Handle.IsReplicated())
 		{
-			It.RemoveCurrent();
-			OnIndicatorRemoved.Broadcast(Instance.ToSharedRef());
+			// local instance of a replicated indicator is owned by its entry, remove the entry instead
+			if (!CanModifyReplicatedIndicators(*FString(__FUNCTION__)))
+			{
+				continue;
+			}
+			
+			if (const TSharedPtr<FIndicatorDescriptorInstance> Instance = RemoveReplicatedEntry(Handle); Instance.IsValid())
+			{
+				Instances.Add(Instance.ToSharedRef());
+			}
+		}
+		else if (const TSharedRef<FIndicatorDescriptorInstance>* Instance = IndicatorsByHandle.Find(Handle))
+		{
+			Instances.Add(*Instance);
 		}
 	}
+	
+	for (const TSharedRef<FIndicatorDescriptorInstance>& Instance: Instances)
+	{
+		RemoveIndicatorInternal(Instance);
+	}
+
+	if (!Instances.IsEmpty())
+	{
+		BroadcastIndicatorsRemoved(Instances);
+	}
+}
+
+void UHUDIndicatorManagerComponent::BroadcastIndicatorsAdded(TConstArrayView<TSharedRef<FIndicatorDescriptorInstance>> Instances)
+{
+	OnIndicatorsAdded.Broadcast(Instances);
+
+	HUDIndicatorManager::ForEachCategoryRun(Instances, [this](FGameplayTag CategoryTag, TConstArrayView<TSharedRef<FIndicatorDescriptorInstance>> CategoryInstances)
+	{
+		if (const FIndicatorCategory* Category = Categories.Find(CategoryTag))
+		{
+			Category->OnIndicatorsAdded.Broadcast(CategoryInstances);
+		}
+	});
+}
+
+void UHUDIndicatorManagerComponent::BroadcastIndicatorsRemoved(TConstArrayView<TSharedRef<FIndicatorDescriptorInstance>> Instances)
+{
+	OnIndicatorsRemoved.Broadcast(Instances);
+
+	HUDIndicatorManager::ForEachCategoryRun(Instances, [this](FGameplayTag CategoryTag, TConstArrayView<TSharedRef<FIndicatorDescriptorInstance>> CategoryInstances)
+	{
+		if (const FIndicatorCategory* Category = Categories.Find(CategoryTag))
+		{
+			Category->OnIndicatorsRemoved.Broadcast(CategoryInstances);
+		}
+	});
+}
+
+void UHUDIndicatorManagerComponent::RemoveIndicators(const AActor* OwnerActor)
+{
+	FIndicatorInstanceList Instances;
+	RemoveIndicatorsByActor(OwnerActor, Instances);
+
+	if (!Instances.IsEmpty())
+	{
+		BroadcastIndicatorsRemoved(Instances);
+	}
 }
 
 void UHUDIndicatorManagerComponent::RemoveIndicators(const USceneComponent* Component)
 {
-	for (auto It = IndicatorInstances.CreateIterator(); It; ++It)
-    {
-    	TSharedPtr<FIndicatorDescriptorInstance> Instance = *It;
-    	if (!IsValid(Instance->Component) || Instance->Component == Component)
-    	{
-    		It.RemoveCurrent();
-    		OnIndicatorRemoved.Broadcast(Instance.ToSharedRef());
-    	}
-    }
+	FIndicatorInstanceList Instances;
+	RemoveIndicatorsByComponent(Component, Instances);
+
+	if (!Instances.IsEmpty())
+	{
+		BroadcastIndicatorsRemoved(Instances);
+	}
+}
+
+void UHUDIndicatorManagerComponent::RemoveIndicators(TConstArrayView<const AActor*> OwnerActors)
+{
+	TArray<TSharedRef<FIndicatorDescriptorInstance>> Instances;
+	for (const AActor* OwnerActor: OwnerActors)
+	{
+		RemoveIndicatorsByActor(OwnerActor, Instances);
+	}
+
+	if (!Instances.IsEmpty())
+	{
+		BroadcastIndicatorsRemoved(Instances);
+	}
+}
+
+void UHUDIndicatorManagerComponent::RemoveIndicators(TConstArrayView<const USceneComponent*> Components)
+{
+	TArray<TSharedRef<FIndicatorDescriptorInstance>> Instances;
+	for (const USceneComponent* Component: Components)
+	{
+		RemoveIndicatorsByComponent(Component, Instances);
+	}
+
+	if (!Instances.IsEmpty())
+	{
+		BroadcastIndicatorsRemoved(Instances);
+	}
+}
+
+void UHUDIndicatorManagerComponent::StartStaleIndicatorSweep()
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr || World->GetTimerManager().IsTimerActive(StaleIndicatorSweepTimer))
+	{
+		return;
+	}
+
+	World->GetTimerManager().SetTimer(StaleIndicatorSweepTimer, this, &ThisClass::RemoveStaleIndicators, StaleIndicatorSweepInterval, true);
+}
+
+void UHUDIndicatorManagerComponent::RemoveStaleIndicators()
+{
+	// component keys are resolved instead of component pointers, so keys of garbage collected components are safe to test
+	TArray<TObjectKey<const USceneComponent>, TInlineAllocator<8>> StaleKeys;
+	for (const auto& [ComponentKey, Instances]: IndicatorsByComponent)
+	{
+		if (!IsValid(ComponentKey.ResolveObjectPtr()))
+		{
+			StaleKeys.Add(ComponentKey);
+		}
+	}
+
+	if (!StaleKeys.IsEmpty())
+	{
+		TArray<TSharedRef<FIndicatorDescriptorInstance>> Instances;
+		for (const TObjectKey<const USceneComponent>& ComponentKey: StaleKeys)
+		{
+			RemoveIndicatorsByComponent(ComponentKey, Instances);
+		}
+
+		UE_LOG(LogIndicators, Verbose, TEXT("%s: Removed %d indicators of destroyed components"), *FString(__FUNCTION__), Instances.Num());
+		BroadcastIndicatorsRemoved(Instances);
+	}
+
+	if (IndicatorsByComponent.IsEmpty())
+	{
+		GetWorld()->GetTimerManager().ClearTimer(StaleIndicatorSweepTimer);
+	}
+}
+
+void UHUDIndicatorManagerComponent::ReleaseRemovedReplicatedInstances()
+{
+	// replicated indicators are few, linear search is fine
+	for (FHUDReplicatedIndicator& Entry: ReplicatedIndicators.Items)
+	{
+		if (Entry.Instance.IsValid() && !IndicatorInstances.Contains(Entry.Instance))
+		{
+			Entry.Instance.Reset();
+		}
+	}
+}
+
+bool UHUDIndicatorManagerComponent::CanModifyReplicatedIndicators(const TCHAR* FunctionName) const
+{
+	if (!bReplicateIndicators)
+	{
+		UE_LOG(LogIndicators, Error, TEXT("%s: replicated indicators are disabled for [%s]"), FunctionName, *GetNameSafe(this));
+		return false;
+	}
+	
+	if (GetOwner() == nullptr || !GetOwner()->HasAuthority())
+	{
+		UE_LOG(LogIndicators, Error, TEXT("%s: replicated indicators can be modified only by server"), FunctionName);
+		return false;
+	}
+	return true;
+}
+
+FHUDIndicatorHandle UHUDIndicatorManagerComponent::AddReplicatedIndicator(const UHUDIndicatorDescriptor* Descriptor, const USceneComponent* Component, FName SocketName, const FHUDWidgetContextHandle& WidgetContext)
+{
+	if (!CanModifyReplicatedIndicators(*FString(__FUNCTION__)))
+	{
+		return {};
+	}
+	
+	if (!IsValid(Component) || Descriptor == nullptr)
+	{
+		UE_LOG(LogIndicators, Error, TEXT("%s: Failed to add indicator with [%s] descriptor for [%s] component"), *FString(__FUNCTION__), *GetNameSafe(Descriptor), *GetNameSafe(Component));
+		return {};
+	}
+
+	FHUDReplicatedIndicator NewEntry;
+	NewEntry.Descriptor = Descriptor;
+	NewEntry.Component = Component;
+	NewEntry.SocketName = SocketName;
+	NewEntry.WidgetContext = WidgetContext;
+	
+	return AddReplicatedIndicatorInternal(MoveTemp(NewEntry));
+}
+
+FHUDIndicatorHandle UHUDIndicatorManagerComponent::AddReplicatedIndicatorAtLocation(const UHUDIndicatorDescriptor* Descriptor, const FVector& WorldLocation, const FHUDWidgetContextHandle& WidgetContext)
+{
+	if (!CanModifyReplicatedIndicators(*FString(__FUNCTION__)))
+	{
+		return {};
+	}
+	
+	if (Descriptor == nullptr)
+	{
+		UE_LOG(LogIndicators, Error, TEXT("%s: Failed to add indicator at [%s], descriptor is null"), *FString(__FUNCTION__), *WorldLocation.ToString());
+		return {};
+	}
+
+	FHUDReplicatedIndicator NewEntry;
+	NewEntry.Descriptor = Descriptor;
+	NewEntry.WorldLocation = WorldLocation;
+	NewEntry.WidgetContext = WidgetContext;
+	NewEntry.bPositional = true;
+	
+	return AddReplicatedIndicatorInternal(MoveTemp(NewEntry));
+}
+
+FHUDIndicatorHandle UHUDIndicatorManagerComponent::AddReplicatedIndicatorInternal(FHUDReplicatedIndicator&& NewEntry)
+{
+	NewEntry.Handle = AllocateIndicatorHandle(true);
+	
+	FHUDReplicatedIndicator& Entry = ReplicatedIndicators.Items.Add_GetRef(MoveTemp(NewEntry));
+	ReplicatedIndicators.MarkItemDirty(Entry);
+
+	// dedicated server doesn't display indicators, keep only the replicated entry
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		Entry.Instance = CreateReplicatedInstance(Entry);
+		if (Entry.Instance.IsValid())
+		{
+			const TSharedRef<FIndicatorDescriptorInstance> NewInstance = Entry.Instance.ToSharedRef();
+			BroadcastIndicatorsAdded(MakeArrayView(&NewInstance, 1));
+		}
+	}
+	
+	return Entry.Handle;
+}
+
+void UHUDIndicatorManagerComponent::SetReplicatedIndicatorLocation(const FHUDIndicatorHandle& Handle, const FVector& WorldLocation)
+{
+	if (!CanModifyReplicatedIndicators(*FString(__FUNCTION__)))
+	{
+		return;
+	}
+
+	// replicated indicators are few, linear search is fine
+	FHUDReplicatedIndicator* Entry = ReplicatedIndicators.Items.FindByPredicate([&Handle](const FHUDReplicatedIndicator& Item)
+	{
+		return Item.Handle == Handle;
+	});
+	if (Entry == nullptr || !Entry->bPositional)
+	{
+		UE_LOG(LogIndicators, Error, TEXT("%s: Failed to find positional replicated indicator"), *FString(__FUNCTION__));
+		return;
+	}
+
+	Entry->WorldLocation = WorldLocation;
+	ReplicatedIndicators.MarkItemDirty(*Entry);
+	if (Entry->Instance.IsValid())
+	{
+		Entry->Instance->WorldLocation = WorldLocation;
+	}
+}
+
+void UHUDIndicatorManagerComponent::RemoveReplicatedIndicator(const FHUDIndicatorHandle& Handle)
+{
+	if (!CanModifyReplicatedIndicators(*FString(__FUNCTION__)))
+	{
+		return;
+	}
+
+	if (const TSharedPtr<FIndicatorDescriptorInstance> Instance = RemoveReplicatedEntry(Handle); Instance.IsValid())
+	{
+		const TSharedRef<FIndicatorDescriptorInstance> RemovedInstance = Instance.ToSharedRef();
+		RemoveIndicatorInternal(RemovedInstance);
+		BroadcastIndicatorsRemoved(MakeArrayView(&RemovedInstance, 1));
+	}
+}
+
+TSharedPtr<FIndicatorDescriptorInstance> UHUDIndicatorManagerComponent::RemoveReplicatedEntry(const FHUDIndicatorHandle& Handle)
+{
+	// replicated indicators are few, linear search is fine
+	const int32 Index = ReplicatedIndicators.Items.IndexOfByPredicate([&Handle](const FHUDReplicatedIndicator& Item)
+	{
+		return Item.Handle == Handle;
+	});
+	if (Index == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	TSharedPtr<FIndicatorDescriptorInstance> Instance = MoveTemp(ReplicatedIndicators.Items[Index].Instance);
+	ReplicatedIndicators.Items.RemoveAtSwap(Index);
+	ReplicatedIndicators.MarkArrayDirty();
+
+	return Instance;
+}
+
+TSharedPtr<FIndicatorDescriptorInstance> UHUDIndicatorManagerComponent::CreateReplicatedInstance(const FHUDReplicatedIndicator& Entry)
+{
+	if (Entry.Descriptor == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (Entry.bPositional)
+	{
+		// local instance shares entry handle, so the handle returned by server is valid on every machine
+		const TSharedRef<FIndicatorDescriptorInstance> NewInstance = AddPositionalIndicatorInternal(Entry.Handle, Entry.Descriptor, Entry.WidgetContext);
+		NewInstance->WorldLocation = Entry.WorldLocation;
+		return NewInstance;
+	}
+
+	if (!IsValid(Entry.Component))
+	{
+		return nullptr;
+	}
+
+	// create context anyway with Descriptor as a data object
+	const TSharedRef<FIndicatorDescriptorInstance> NewInstance = MakeShared<FIndicatorDescriptorInstance>(Entry.Descriptor, Entry.Component, Entry.SocketName,
+		Entry.WidgetContext.IsValid() ? Entry.WidgetContext : CreateWidgetContext(nullptr, Entry.Descriptor));
+	NewInstance->OwnerKey = Entry.Component->GetOwner();
+	AddIndicatorInternal(NewInstance);
+	
+	return NewInstance;
+}
+
+template <typename TAllocator>
+void UHUDIndicatorManagerComponent::RemoveIndicatorsByActor(const AActor* OwnerActor, TArray<TSharedRef<FIndicatorDescriptorInstance>, TAllocator>& OutInstances)
+{
+	FIndicatorInstanceList Instances;
+	if (IndicatorsByActor.RemoveAndCopyValue(OwnerActor, Instances))
+	{
+		for (const TSharedRef<FIndicatorDescriptorInstance>& Instance: Instances)
+		{
+			RemoveIndicatorInternal(Instance);
+		}
+		ReleaseRemovedReplicatedInstances();
+		OutInstances.Append(Instances);
+	}
+}
+
+template <typename TAllocator>
+void UHUDIndicatorManagerComponent::RemoveIndicatorsByComponent(const TObjectKey<const USceneComponent>& ComponentKey, TArray<TSharedRef<FIndicatorDescriptorInstance>, TAllocator>& OutInstances)
+{
+	FIndicatorInstanceList Instances;
+	if (IndicatorsByComponent.RemoveAndCopyValue(ComponentKey, Instances))
+	{
+		for (const TSharedRef<FIndicatorDescriptorInstance>& Instance: Instances)
+		{
+			RemoveIndicatorInternal(Instance);
+		}
+		ReleaseRemovedReplicatedInstances();
+		OutInstances.Append(Instances);
+	}
 }
@@ -5,6 +5,35 @@
 #include "Indicators/HUDIndicatorManagerComponent.h"
 #include "Indicators/HUDIndicatorWidgetInterface.h"
 #include "ViewModel/HUDWidgetContextSubsystem.h"
+#include "CollisionQueryParams.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+DECLARE_CYCLE_STAT(TEXT("UpdateIndicators"),			STAT_HUD_Framework_UpdateIndicators,		STATGROUP_HUD_Framework);
+DECLARE_CYCLE_STAT(TEXT("ArrangeIndicators"),			STAT_HUD_Framework_ArrangeIndicators,		STATGROUP_HUD_Framework);
+DECLARE_CYCLE_STAT(TEXT("CreateIndicatorWidget"),		STAT_HUD_Framework_CreateIndicatorWidget,	STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Indicators Projected"),	STAT_HUD_Framework_IndicatorsProjected,		STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Indicators Culled"),		STAT_HUD_Framework_IndicatorsCulled,		STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Indicators Clamped"),		STAT_HUD_Framework_IndicatorsClamped,		STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Indicators Tracked"),		STAT_HUD_Framework_IndicatorsTracked,		STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Indicators Materialized"),	STAT_HUD_Framework_IndicatorsMaterialized,	STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Indicators Painted"),		STAT_HUD_Framework_IndicatorsPainted,		STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Indicator Paint Batches"),	STAT_HUD_Framework_IndicatorPaintBatches,	STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Canvas Invalidations"),	STAT_HUD_Framework_CanvasInvalidations,		STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Occlusion Traces"),		STAT_HUD_Framework_OcclusionTraces,			STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Arrange Allocations"),		STAT_HUD_Framework_ArrangeAllocations,		STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Update Allocations"),		STAT_HUD_Framework_UpdateAllocations,		STATGROUP_HUD_Framework);
+
+TRACE_DECLARE_INT_COUNTER(HUDFramework_IndicatorsProjected,	TEXT("HUDFramework/IndicatorsProjected"));
+TRACE_DECLARE_INT_COUNTER(HUDFramework_IndicatorsCulled,	TEXT("HUDFramework/IndicatorsCulled"));
+TRACE_DECLARE_INT_COUNTER(HUDFramework_IndicatorsClamped,	TEXT("HUDFramework/IndicatorsClamped"));
+TRACE_DECLARE_INT_COUNTER(HUDFramework_IndicatorsTracked,	TEXT("HUDFramework/IndicatorsTracked"));
+TRACE_DECLARE_INT_COUNTER(HUDFramework_IndicatorsMaterialized,	TEXT("HUDFramework/IndicatorsMaterialized"));
+TRACE_DECLARE_INT_COUNTER(HUDFramework_IndicatorsPainted,	TEXT("HUDFramework/IndicatorsPainted"));
+TRACE_DECLARE_INT_COUNTER(HUDFramework_IndicatorPaintBatches,	TEXT("HUDFramework/IndicatorPaintBatches"));
+TRACE_DECLARE_INT_COUNTER(HUDFramework_OcclusionTraces,	TEXT("HUDFramework/OcclusionTraces"));
 
 // Hope this namespace helps understand code better
 namespace Private
@@ -34,6 +63,128 @@ namespace Private
 		FVector2D(0.f, 1.f)
 	};
 
+	/**
+	 * Adds number of allocations made during its scope to a stat counter
+	 * Counts allocations from all threads, so only zero proves that scope doesn't allocate
+	 */
+	struct FScopedAllocationCounter
+	{
+#if STATS && UE_STATS
+		explicit FScopedAllocationCounter(TStatId InStatId)
+			: StatId(InStatId)
+			, StartMallocCalls(FMalloc::TotalMallocCalls)
+		{}
+
+		~FScopedAllocationCounter()
+		{
+			const uint64 NumAllocations = FMalloc::TotalMallocCalls - StartMallocCalls;
+			INC_DWORD_STAT_BY_FName(StatId.GetName(), NumAllocations);
+		}
+
+		TStatId StatId;
+		uint64 StartMallocCalls = 0;
+#else
+		explicit FScopedAllocationCounter(TStatId) {}
+#endif
+	};
+	
+	/**
+	 * @return ray parameter at which ray from the rectangle center along @Direction exits rectangle with @Extent half size
+	 * @param OutEdge rectangle edge ray exits through
+	 */
+	FORCEINLINE float RayRectExit(const FVector2f& Direction, const FVector2f& Extent, EDirection& OutEdge)
+	{
+		const float TX = Direction.X != 0.f ? Extent.X / FMath::Abs(Direction.X) : TNumericLimits<float>::Max();
+		const float TY = Direction.Y != 0.f ? Extent.Y / FMath::Abs(Direction.Y) : TNumericLimits<float>::Max();
+		if (TX < TY)
+		{
+			OutEdge = Direction.X > 0.f ? EDirection::Right : EDirection::Left;
+			return TX;
+		}
+		
+		OutEdge = Direction.Y > 0.f ? EDirection::Bottom : EDirection::Top;
+		return TY;
+	}
+
+	/** @return rotation of an arrow pointing along @Direction, arrow points up with zero rotation */
+	FORCEINLINE float GetArrowRotation(const FVector2f& Direction)
+	{
+		return FMath::RadiansToDegrees(FMath::Atan2(Direction.Y, Direction.X)) + 90.f;
+	}
+
+	void ClampToRectangle(FIndicatorClampBatch& Batch)
+	{
+		for (int32 Index = 0; Index < Batch.Num(); ++Index)
+		{
+			const FVector2f Direction = Batch.Positions[Index] - Batch.Centers[Index];
+			const FVector2f Extent = Batch.Extents[Index];
+			
+			EDirection Edge = EDirection::MAX;
+			if (FMath::Abs(Direction.X) > Extent.X || FMath::Abs(Direction.Y) > Extent.Y)
+			{
+				Batch.ClampedPositions[Index] = Batch.Centers[Index] + Direction * RayRectExit(Direction, Extent, Edge);
+				Batch.Rotations[Index] = ArrowRotations[static_cast<int32>(Edge)];
+			}
+			Batch.Directions[Index] = static_cast<uint8>(Edge);
+		}
+	}
+
+	void ClampToEllipse(FIndicatorClampBatch& Batch)
+	{
+		for (int32 Index = 0; Index < Batch.Num(); ++Index)
+		{
+			const FVector2f Direction = Batch.Positions[Index] - Batch.Centers[Index];
+			const FVector2f Extent = Batch.Extents[Index];
+			const float SizeSquared = (Direction / Extent).SizeSquared();
+			
+			EDirection Edge = EDirection::MAX;
+			if (SizeSquared > 1.f)
+			{
+				// edge is used for arrow placement only
+				RayRectExit(Direction, Extent, Edge);
+				Batch.ClampedPositions[Index] = Batch.Centers[Index] + Direction * FMath::InvSqrt(SizeSquared);
+				Batch.Rotations[Index] = GetArrowRotation(Direction);
+			}
+			Batch.Directions[Index] = static_cast<uint8>(Edge);
+		}
+	}
+
+	void ClampToRoundedRectangle(FIndicatorClampBatch& Batch, float CornerRadius)
+	{
+		for (int32 Index = 0; Index < Batch.Num(); ++Index)
+		{
+			const FVector2f Direction = Batch.Positions[Index] - Batch.Centers[Index];
+			const FVector2f Extent = Batch.Extents[Index];
+			const float Radius = FMath::Min3(CornerRadius, Extent.X, Extent.Y);
+			// rectangle of corner circle centers
+			const FVector2f InnerExtent = Extent - FVector2f{Radius};
+
+			// signed distance to the rounded rectangle, mirrored to the first quadrant
+			const FVector2f AbsDirection = Direction.GetAbs();
+			const FVector2f Q = AbsDirection - InnerExtent;
+			const float Distance = FVector2f::Max(Q, FVector2f::ZeroVector).Size() + FMath::Min(Q.GetMax(), 0.f) - Radius;
+
+			EDirection Edge = EDirection::MAX;
+			if (Distance > 0.f)
+			{
+				float T = RayRectExit(Direction, Extent, Edge);
+				const FVector2f Exit = AbsDirection * T;
+				if (Exit.X > InnerExtent.X && Exit.Y > InnerExtent.Y)
+				{
+					// ray exits through a corner, intersect it with the corner circle
+					const float A = AbsDirection.SizeSquared();
+					const float B = AbsDirection | InnerExtent;
+					const float C = InnerExtent.SizeSquared() - Radius * Radius;
+					T = (B + FMath::Sqrt(FMath::Max(B * B - A * C, 0.f))) / A;
+				}
+				
+				Batch.ClampedPositions[Index] = Batch.Centers[Index] + Direction * T;
+				Batch.Rotations[Index] = GetArrowRotation(Direction);
+			}
+			Batch.Directions[Index] = static_cast<uint8>(Edge);
+		}
+	}
+	
 	struct FSlotSizeAndOffset
 	{
 		explicit FSlotSizeAndOffset(const SIndicatorCanvas::FSlot& IndicatorSlot, bool bApplyScale = false);
@@ -43,47 +194,68 @@ namespace Private
 		FVector2D PaddingMin = FVector2D::ZeroVector;
 		FVector2D PaddingMax = FVector2D::ZeroVector;
 	};
-}
 
-int32 SIndicatorCanvasArrowWidget::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
-{
-	int32 MaxLayerId = LayerId;
-	
-	if (ArrowBrush != nullptr)
+	bool bForceGenericArrange = false;
+	FAutoConsoleVariableRef CVarForceGenericArrange(
+		TEXT("HUD.Indicators.ForceGenericArrange"),
+		bForceGenericArrange,
+		TEXT("Arrange indicators with a single loop that checks descriptor features per indicator, instead of loops specialized per feature set")
+	);
+
+	/** Descriptor features indicator arrange loops are specialized on */
+	enum class EArrangeFeatures : uint8
 	{
-		const bool bShouldBeEnabled = ShouldBeEnabled(bParentEnabled);
-		const ESlateDrawEffect DrawEffect = bShouldBeEnabled ? ESlateDrawEffect::None : ESlateDrawEffect::DisabledEffect;
-		const FColor FinalColorAndOpacity = (InWidgetStyle.GetColorAndOpacityTint() * ArrowBrush->GetTint(InWidgetStyle)).ToFColor(true);
-	
-		FSlateDrawElement::MakeRotatedBox(
-			OutDrawElements,
-			MaxLayerId,
-			AllottedGeometry.ToPaintGeometry(ArrowBrush->ImageSize, FSlateLayoutTransform()),
-			ArrowBrush, DrawEffect,
-			FMath::DegreesToRadians(Rotation),
-			TOptional<FVector2D>(),
-			FSlateDrawElement::RelativeToElement,
-			FinalColorAndOpacity);
-	
-		MaxLayerId++;
-	}
-	
-	return MaxLayerId;
-}
+		None			= 0,
+		Scaling			= 1 << 0,
+		Clamp			= 1 << 1,
+		ClampArrow		= 1 << 2,
+		IgnoreCanRender	= 1 << 3,
+	};
+	constexpr int32 NumArrangeFeatureSets = 1 << 4;
 
-FVector2D SIndicatorCanvasArrowWidget::ComputeDesiredSize(float) const
-{
-	if (ArrowBrush != nullptr)
+	FORCEINLINE uint8 GetArrangeFeatures(const FHUDIndicatorDescriptorRuntimeData& RuntimeData)
 	{
-		return ArrowBrush->GetImageSize();
+		uint8 Features = 0;
+		Features |= RuntimeData.HasAnyFlags(EHUDIndicatorDescriptorFlags::EnableScaling) ? uint8(EArrangeFeatures::Scaling) : 0;
+		if (RuntimeData.HasAnyFlags(EHUDIndicatorDescriptorFlags::ClampToScreen))
+		{
+			Features |= uint8(EArrangeFeatures::Clamp);
+			Features |= RuntimeData.HasAnyFlags(EHUDIndicatorDescriptorFlags::ShowClampToScreenArrow) ? uint8(EArrangeFeatures::ClampArrow) : 0;
+		}
+		Features |= RuntimeData.HasAnyFlags(EHUDIndicatorDescriptorFlags::DisplayWhenCannotRender) ? uint8(EArrangeFeatures::IgnoreCanRender) : 0;
+		return Features;
 	}
-	return FVector2D::ZeroVector;
-}
 
-void SIndicatorCanvasArrowWidget::Construct(const FArguments& InArgs, const FSlateBrush* InArrowBrush)
-{
-	this->ArrowBrush = InArrowBrush;
-	SetCanTick(false);
+	/** Feature set known at compile time */
+	template <uint8 Features>
+	struct TStaticArrangeFeatures
+	{
+		static constexpr bool Has(const FHUDIndicatorDescriptorRuntimeData&, EArrangeFeatures Feature)
+		{
+			return (Features & uint8(Feature)) != 0;
+		}
+	};
+
+	/** Feature read from descriptor runtime data flags of each indicator */
+	struct FDynamicArrangeFeatures
+	{
+		static FORCEINLINE bool Has(const FHUDIndicatorDescriptorRuntimeData& RuntimeData, EArrangeFeatures Feature)
+		{
+			switch (Feature)
+			{
+			case EArrangeFeatures::Scaling:
+				return RuntimeData.HasAnyFlags(EHUDIndicatorDescriptorFlags::EnableScaling);
+			case EArrangeFeatures::Clamp:
+				return RuntimeData.HasAnyFlags(EHUDIndicatorDescriptorFlags::ClampToScreen);
+			case EArrangeFeatures::ClampArrow:
+				return RuntimeData.HasAnyFlags(EHUDIndicatorDescriptorFlags::ClampToScreen) && RuntimeData.HasAnyFlags(EHUDIndicatorDescriptorFlags::ShowClampToScreenArrow);
+			case EArrangeFeatures::IgnoreCanRender:
+				return RuntimeData.HasAnyFlags(EHUDIndicatorDescriptorFlags::DisplayWhenCannotRender);
+			default:
+				return false;
+			}
+		}
+	};
 }
 
 void SIndicatorCanvas::Construct(const FArguments& InArgs, const FLocalPlayerContext& InLocalPlayerContext, const FGameplayTagContainer& InCategoryTags, const FSlateBrush* InArrowBrush)
@@ -91,6 +263,7 @@ void SIndicatorCanvas::Construct(const FArguments& InArgs, const FLocalPlayerCon
 	LocalPlayerContext = InLocalPlayerContext;
 	CategoryTags = InCategoryTags;
 	ArrowBrush = InArrowBrush;
+	Settings = InArgs._Settings;
 
 	SetCanTick(false);
 	SetVisibility(EVisibility::SelfHitTestInvisible);
@@ -100,12 +273,19 @@ void SIndicatorCanvas::Construct(const FArguments& InArgs, const FLocalPlayerCon
 
 void SIndicatorCanvas::OnArrangeChildren(const FGeometry& AllottedGeometry, FArrangedChildren& ArrangedChildren) const
 {
-	FScopedArrowChildren ScopedArrowChildren(&ArrowChildren, ArrowBrush);
+	SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_ArrangeIndicators);
+	LLM_SCOPE_BYTAG(HUDFramework_IndicatorCanvas);
+	Private::FScopedAllocationCounter AllocationCounter{GET_STATID(STAT_HUD_Framework_ArrangeAllocations)};
+	
+	ArrowInstances.Reset();
+	ArrangedSlots.Reset();
 
 	if (bShowAnyIndicators)
 	{
-		TArray<const FSlot*> SortedSlots;
-		// Reserve space for slots
+		[[maybe_unused]] int32 NumCulled = 0;
+
+		// reuse sorted slots storage between frames
+		SortedSlots.Reset();
 		SortedSlots.Reserve(SlotChildren.Num());
 		// Copy slot children
 		for (int32 ChildIndex = 0; ChildIndex < SlotChildren.Num(); ChildIndex++)
@@ -119,52 +299,134 @@ void SIndicatorCanvas::OnArrangeChildren(const FGeometry& AllottedGeometry, FArr
 			return A.GetPriority() == B.GetPriority() ? A.GetDepth() > B.GetDepth() : A.GetPriority() < B.GetPriority();
 		});
 
-		for (const FSlot*& Slot : SortedSlots)
+		ArrangeEntries.SetNum(SortedSlots.Num(), EAllowShrinking::No);
+		ArrangeOrder.SetNumUninitialized(SortedSlots.Num(), EAllowShrinking::No);
+		
+		if (Private::bForceGenericArrange)
 		{
-			const TSharedRef<FIndicatorDescriptorInstance> IndicatorInstance = Slot->GetIndicatorDescriptorInstance();
-
-			// Skip indicator if it is not match requirements
-			if (!ArrangedChildren.Accepts(Slot->GetWidget()->GetVisibility()) || Slot->ShouldSkipIndicator())
+			for (int32 SortedIndex = 0; SortedIndex < SortedSlots.Num(); ++SortedIndex)
 			{
-				Slot->SetWasIndicatorClamped(false);
-				continue;
+				ArrangeOrder[SortedIndex] = SortedIndex;
 			}
-
-			const float IndicatorScale = Slot->GetIndicatorScale();
-
-			bool bWasIndicatorClamped = false;
-			FVector2D ClampedScreenPosition = FVector2D::ZeroVector;
-			if (IndicatorInstance->Descriptor->bClampToScreen)
+			ArrangeSlots<Private::FDynamicArrangeFeatures>(ArrangeOrder, ArrangedChildren);
+		}
+		else
+		{
+			// group slots by feature set, counting sort keeps them in sorted order within each group
+			int32 GroupOffsets[Private::NumArrangeFeatureSets + 1] = {};
+			ArrangeFeatures.SetNumUninitialized(SortedSlots.Num(), EAllowShrinking::No);
+			for (int32 SortedIndex = 0; SortedIndex < SortedSlots.Num(); ++SortedIndex)
 			{
-				const uint8 ClampDirection =
-					ClampIndicator(*Slot, AllottedGeometry.GetLocalSize(), ClampedScreenPosition);
+				const uint8 Features = Private::GetArrangeFeatures(SortedSlots[SortedIndex]->GetRuntimeData());
+				ArrangeFeatures[SortedIndex] = Features;
+				++GroupOffsets[Features + 1];
+			}
+			for (int32 Features = 0; Features < Private::NumArrangeFeatureSets; ++Features)
+			{
+				GroupOffsets[Features + 1] += GroupOffsets[Features];
+			}
 
-				bWasIndicatorClamped = static_cast<Private::EDirection>(ClampDirection) != Private::EDirection::MAX;
+			int32 GroupCursors[Private::NumArrangeFeatureSets];
+			FMemory::Memcpy(GroupCursors, GroupOffsets, sizeof(GroupCursors));
+			for (int32 SortedIndex = 0; SortedIndex < SortedSlots.Num(); ++SortedIndex)
+			{
+				ArrangeOrder[GroupCursors[ArrangeFeatures[SortedIndex]]++] = SortedIndex;
+			}
 
-				// Should we draw arrow
-				if (bWasIndicatorClamped && IndicatorInstance->Descriptor->bShowClampToScreenArrow)
+			using FArrangeSlotsFunc = void (SIndicatorCanvas::*)(TConstArrayView<int32>, const FArrangedChildren&) const;
+			static constexpr FArrangeSlotsFunc ArrangeFunctions[Private::NumArrangeFeatureSets] =
+			{
+				&SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<0>>,  &SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<1>>,
+				&SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<2>>,  &SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<3>>,
+				&SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<4>>,  &SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<5>>,
+				&SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<6>>,  &SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<7>>,
+				&SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<8>>,  &SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<9>>,
+				&SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<10>>, &SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<11>>,
+				&SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<12>>, &SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<13>>,
+				&SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<14>>, &SIndicatorCanvas::ArrangeSlots<Private::TStaticArrangeFeatures<15>>,
+			};
+			
+			for (int32 Features = 0; Features < Private::NumArrangeFeatureSets; ++Features)
+			{
+				const int32 GroupSize = GroupOffsets[Features + 1] - GroupOffsets[Features];
+				if (GroupSize > 0)
 				{
-					AddArrowWidget(
-						AllottedGeometry,
-						ArrangedChildren,
-						ScopedArrowChildren,
-						ClampDirection,
-						ClampedScreenPosition,
-						Slot->GetWidget()->GetDesiredSize() * IndicatorScale,
-						IndicatorInstance->Descriptor->VerticalAlignment);
+					(this->*ArrangeFunctions[Features])(MakeArrayView(ArrangeOrder.GetData() + GroupOffsets[Features], GroupSize), ArrangedChildren);
 				}
 			}
+		}
+
+		// add arranged widgets in sorted order
+		for (int32 SortedIndex = 0; SortedIndex < SortedSlots.Num(); ++SortedIndex)
+		{
+			const FArrangeEntry& Entry = ArrangeEntries[SortedIndex];
+			if (Entry.bSkip)
+			{
+				++NumCulled;
+				continue;
+			}
 			
-			Slot->SetWasIndicatorClamped(bWasIndicatorClamped);
+			const FSlot* Slot = SortedSlots[SortedIndex];
+			ArrangedChildren.AddWidget(AllottedGeometry.MakeChild(Slot->GetWidget(), FLayoutGeometry{Entry.Transform, Entry.Size}));
+			ArrangedSlots.Add(Slot);
+		}
 
-			FVector2D ScreenPosition = bWasIndicatorClamped ? ClampedScreenPosition : Slot->GetScreenPosition();
+		INC_DWORD_STAT_BY(STAT_HUD_Framework_IndicatorsCulled, NumCulled);
+		TRACE_COUNTER_SET(HUDFramework_IndicatorsCulled, NumCulled);
+	}
+}
 
-			// Get params without scale because it will be applied by slate.
-			Private::FSlotSizeAndOffset Params(*Slot);
-			
-			const FLayoutGeometry Geometry(FSlateLayoutTransform(IndicatorScale, ScreenPosition + Params.Offset * IndicatorScale), Params.Size);
-			ArrangedChildren.AddWidget(AllottedGeometry.MakeChild(Slot->GetWidget(), Geometry));
+template <typename TFeatures>
+void SIndicatorCanvas::ArrangeSlots(TConstArrayView<int32> SortedIndexes, const FArrangedChildren& ArrangedChildren) const
+{
+	using Private::EArrangeFeatures;
+	
+	for (const int32 SortedIndex: SortedIndexes)
+	{
+		const FSlot* Slot = SortedSlots[SortedIndex];
+		FArrangeEntry& Entry = ArrangeEntries[SortedIndex];
+		const FHUDIndicatorDescriptorRuntimeData& RuntimeData = Slot->GetRuntimeData();
+		const FIndicatorDescriptorInstance& Instance = *Slot->GetIndicatorDescriptorInstance();
+
+		const float IndicatorScale = TFeatures::Has(RuntimeData, EArrangeFeatures::Scaling) ? Slot->GetIndicatorScale() : 1.f;
+
+		// Skip indicator if it is not match requirements
+		Entry.bSkip = !ArrangedChildren.Accepts(Slot->GetWidget()->GetVisibility()) || !Slot->HasValidScreenPosition()
+			|| Slot->WasUserWidgetManuallyCollapsed() || !Instance.HasValidTarget();
+		if (TFeatures::Has(RuntimeData, EArrangeFeatures::Scaling))
+		{
+			Entry.bSkip = Entry.bSkip || FMath::IsNearlyZero(IndicatorScale);
 		}
+		// positional indicators have no component to render
+		if (!TFeatures::Has(RuntimeData, EArrangeFeatures::IgnoreCanRender) && !Instance.IsPositional())
+		{
+			Entry.bSkip = Entry.bSkip || !Instance.Component->CanEverRender();
+		}
+		
+		if (Entry.bSkip)
+		{
+			continue;
+		}
+
+		// clamp results are calculated during canvas update
+		const bool bWasIndicatorClamped = TFeatures::Has(RuntimeData, EArrangeFeatures::Clamp) && Slot->WasIndicatorClamped();
+		if (TFeatures::Has(RuntimeData, EArrangeFeatures::ClampArrow) && bWasIndicatorClamped)
+		{
+			AddArrow(
+				GetArrowBrush(Instance.Descriptor),
+				Slot->GetClampDirection(),
+				Slot->GetArrowRotation(),
+				Slot->GetClampedScreenPosition(),
+				Slot->GetWidget()->GetDesiredSize() * IndicatorScale,
+				RuntimeData.Alignment.Y);
+		}
+		
+		const FVector2D ScreenPosition = bWasIndicatorClamped ? Slot->GetClampedScreenPosition() : Slot->GetScreenPosition();
+
+		// Get params without scale because it will be applied by slate.
+		const Private::FSlotSizeAndOffset Params(*Slot);
+		Entry.Transform = FSlateLayoutTransform(IndicatorScale, ScreenPosition + Params.Offset * IndicatorScale);
+		Entry.Size = Params.Size;
 	}
 }
 
@@ -172,30 +434,129 @@ int32 SIndicatorCanvas::OnPaint(const FPaintArgs& Args, const FGeometry& Allotte
 {
 	CachedAllottedGeometry = AllottedGeometry;
 
-	FArrangedChildren ArrangedChildren(EVisibility::Visible);
+	// reuse arranged children storage between frames
+	FArrangedChildren& ArrangedChildren = CachedArrangedChildren;
+	ArrangedChildren.GetInternalArray().Reset();
 	ArrangeChildren(AllottedGeometry, ArrangedChildren);
 
 	int32 MaxLayerId = LayerId;
 
 	const FPaintArgs NewArgs = Args.WithNewParent(this);
 	const bool bShouldBeEnabled = ShouldBeEnabled(bParentEnabled);
+	[[maybe_unused]] int32 NumPainted = 0;
+	int32 NumPaintBatches = 0;
 
-	for (const FArrangedWidget& ArrangedChild : ArrangedChildren.GetInternalArray())
+	const bool bGroupPaintLayers = Settings.bGroupPaintLayers;
+	BuildPaintEntries(bGroupPaintLayers);
+
+	int32 ChildLayerId = LayerId;
+	uint64 CurrentGroupKey = 0;
+	
+	for (const FPaintEntry& Entry: PaintEntries)
 	{
+		const FArrangedWidget& ArrangedChild = ArrangedChildren[Entry.ChildIndex];
 		if (!IsChildWidgetCulled(MyCullingRect, ArrangedChild))
 		{
+			// every group of indicators is painted above the previous group, so groups don't interleave their draw elements
+			if (NumPaintBatches == 0 || Entry.GroupKey != CurrentGroupKey)
+			{
+				ChildLayerId = bGroupPaintLayers && NumPaintBatches > 0 ? MaxLayerId + 1 : LayerId;
+				CurrentGroupKey = Entry.GroupKey;
+				++NumPaintBatches;
+			}
+			
 			const int32 WidgetMaxLayerId = ArrangedChild.Widget->Paint(
-				NewArgs, ArrangedChild.Geometry, MyCullingRect,OutDrawElements, LayerId, InWidgetStyle, bShouldBeEnabled);
+				NewArgs, ArrangedChild.Geometry, MyCullingRect,OutDrawElements, ChildLayerId, InWidgetStyle, bShouldBeEnabled);
 
 			MaxLayerId = FMath::Max(MaxLayerId, WidgetMaxLayerId);
+			++NumPainted;
 		}
 	}
+	INC_DWORD_STAT_BY(STAT_HUD_Framework_IndicatorsPainted, NumPainted);
+	TRACE_COUNTER_SET(HUDFramework_IndicatorsPainted, NumPainted);
+	INC_DWORD_STAT_BY(STAT_HUD_Framework_IndicatorPaintBatches, NumPaintBatches);
+	TRACE_COUNTER_SET(HUDFramework_IndicatorPaintBatches, NumPaintBatches);
+
+	// don't keep child widgets alive until the next paint
+	ArrangedChildren.GetInternalArray().Reset();
+	ArrangedSlots.Reset();
 
+	// arrows are drawn directly instead of being child widgets
+	if (!ArrowInstances.IsEmpty())
+	{
+		const int32 ArrowLayerId = MaxLayerId + 1;
+		const ESlateDrawEffect DrawEffect = bShouldBeEnabled ? ESlateDrawEffect::None : ESlateDrawEffect::DisabledEffect;
+		
+		for (const FArrowInstance& Arrow: ArrowInstances)
+		{
+			const FColor FinalColorAndOpacity = (InWidgetStyle.GetColorAndOpacityTint() * Arrow.Brush->GetTint(InWidgetStyle)).ToFColor(true);
+			
+			FSlateDrawElement::MakeRotatedBox(
+				OutDrawElements,
+				ArrowLayerId,
+				AllottedGeometry.ToPaintGeometry(Arrow.Brush->ImageSize, FSlateLayoutTransform(Arrow.Position)),
+				Arrow.Brush, DrawEffect,
+				FMath::DegreesToRadians(Arrow.Rotation),
+				TOptional<FVector2D>(),
+				FSlateDrawElement::RelativeToElement,
+				FinalColorAndOpacity);
+		}
+		MaxLayerId = ArrowLayerId;
+	}
+	
 	return MaxLayerId;
 }
 
+void SIndicatorCanvas::BuildPaintEntries(bool bGroupPaintLayers) const
+{
+	PaintEntries.Reset();
+	PaintEntries.Reserve(ArrangedSlots.Num());
+
+	if (!bGroupPaintLayers)
+	{
+		// paint in arrange order, every run of indicators with the same descriptor is counted as a separate batch
+		for (int32 ChildIndex = 0; ChildIndex < ArrangedSlots.Num(); ++ChildIndex)
+		{
+			const UHUDIndicatorDescriptor* Descriptor = ArrangedSlots[ChildIndex]->GetIndicatorDescriptorInstance()->Descriptor;
+			PaintEntries.Add(FPaintEntry{ChildIndex, reinterpret_cast<UPTRINT>(Descriptor)});
+		}
+		return;
+	}
+
+	// arranged slots are sorted by priority, group indicators of the same descriptor within each priority band
+	// group key is a band index followed by the order in which descriptor first appears in the band
+	uint32 BandIndex = 0;
+	for (int32 ChildIndex = 0; ChildIndex < ArrangedSlots.Num(); ++ChildIndex)
+	{
+		const FSlot* Slot = ArrangedSlots[ChildIndex];
+		if (ChildIndex > 0 && Slot->GetPriority() != ArrangedSlots[ChildIndex - 1]->GetPriority())
+		{
+			++BandIndex;
+			PaintGroupIndices.Reset();
+		}
+
+		const UHUDIndicatorDescriptor* Descriptor = Slot->GetIndicatorDescriptorInstance()->Descriptor;
+		const uint32 GroupIndex = static_cast<uint32>(PaintGroupIndices.FindOrAdd(Descriptor, PaintGroupIndices.Num()));
+		
+		PaintEntries.Add(FPaintEntry{ChildIndex, static_cast<uint64>(BandIndex) << 32 | GroupIndex});
+	}
+	PaintGroupIndices.Reset();
+
+	// stable sort keeps depth order inside each group
+	PaintEntries.StableSort([](const FPaintEntry& A, const FPaintEntry& B)
+	{
+		return A.GroupKey < B.GroupKey;
+	});
+}
+
 void SIndicatorCanvas::ProjectIndicator(const TSharedRef<FIndicatorDescriptorInstance>& Instance, const FVector2f& ScreenSize, FIndicatorProjectionResult& Result)
 {
+	if (Instance->IsPositional())
+	{
+		Instance->Descriptor->ProjectionMode->ProjectWorldLocation(Instance->GetWorldLocation(), LocalPlayerContext, ScreenSize, Result);
+		return;
+	}
+	
 	Instance->Descriptor->ProjectionMode->Project(
 		Instance->Component,
 		Instance->SocketName,
@@ -206,7 +567,7 @@ void SIndicatorCanvas::ProjectIndicator(const TSharedRef<FIndicatorDescriptorIns
 
 void SIndicatorCanvas::UpdateActiveTimer()
 {
-	const bool bNeedsTicks = SlotChildren.Num() > 0 || !IndicatorManager.IsValid();
+	const bool bNeedsTicks = TrackedIndicators.Num() > 0 || !IndicatorManager.IsValid();
 
 	if (bNeedsTicks && !TickHandle.IsValid())
 	{
@@ -237,7 +598,7 @@ EActiveTimerReturnType SIndicatorCanvas::UpdateCanvas(double InCurrentTime, floa
 		}
 		else
 		{
-			check(SlotChildren.Num() == 0);
+			check(TrackedIndicators.Num() == 0);
 			return EActiveTimerReturnType::Continue;
 		}
 	}
@@ -246,9 +607,12 @@ EActiveTimerReturnType SIndicatorCanvas::UpdateCanvas(double InCurrentTime, floa
 	{
 		SetShowAnyIndicators(true);
 
-		if (UpdateIndicators())
+		// indicator widgets are arranged during paint and canvas desired size is always zero,
+		// so indicator changes never need layout invalidation of the canvas or its parents
+		if (UpdateIndicators(InCurrentTime))
 		{
 			Invalidate(EInvalidateWidgetReason::Paint);
+			INC_DWORD_STAT(STAT_HUD_Framework_CanvasInvalidations);
 		}
 	}
 	else
@@ -256,7 +620,7 @@ EActiveTimerReturnType SIndicatorCanvas::UpdateCanvas(double InCurrentTime, floa
 		SetShowAnyIndicators(false);
 	}
 
-	if (SlotChildren.Num() == 0)
+	if (TrackedIndicators.Num() == 0)
 	{
 		TickHandle.Reset();
 		return EActiveTimerReturnType::Stop;
@@ -265,93 +629,161 @@ EActiveTimerReturnType SIndicatorCanvas::UpdateCanvas(double InCurrentTime, floa
 	return EActiveTimerReturnType::Continue;
 }
 
-void SIndicatorCanvas::HandleIndicatorAdded(const TSharedRef<FIndicatorDescriptorInstance>& IndicatorInstance)
+void SIndicatorCanvas::HandleIndicatorsAdded(TConstArrayView<TSharedRef<FIndicatorDescriptorInstance>> IndicatorInstances)
 {
-	// Skip this indicator if this is not our category
-	if (!CategoryTags.HasTagExact(IndicatorInstance->Descriptor->CategoryTag))
+	LLM_SCOPE_BYTAG(HUDFramework_IndicatorCanvas);
+
+	// Indicators are already filtered by our categories
+	// Track indicators only, widgets are created once indicators become visible
+	TrackedIndicators.Reserve(TrackedIndicators.Num() + IndicatorInstances.Num());
+	for (const TSharedRef<FIndicatorDescriptorInstance>& IndicatorInstance: IndicatorInstances)
 	{
-		return;
+		TrackedIndices.Add(&IndicatorInstance.Get(), TrackedIndicators.Emplace(IndicatorInstance));
 	}
-	
-	// Dont check on validity because of meta = (Validate)
-	TSoftClassPtr<UUserWidget> IndicatorWidgetClass = IndicatorInstance->Descriptor->IndicatorWidgetClass;
 
-	// Make weak pointer. Indicator can be removed during loading
-	TWeakPtr<FIndicatorDescriptorInstance> WeakInstance = IndicatorInstance;
-	
-	AsyncLoad(IndicatorWidgetClass, [this, WeakInstance, IndicatorWidgetClass]()
+	UpdateActiveTimer();
+}
+
+void SIndicatorCanvas::HandleIndicatorsRemoved(TConstArrayView<TSharedRef<FIndicatorDescriptorInstance>> IndicatorInstances)
+{
+	for (const TSharedRef<FIndicatorDescriptorInstance>& IndicatorInstance: IndicatorInstances)
 	{
-		if (const TSharedPtr<FIndicatorDescriptorInstance> SharedInstance = WeakInstance.Pin())
+		if (const int32* TrackedIndex = TrackedIndices.Find(&IndicatorInstance.Get()))
 		{
-			UUserWidget* IndicatorWidget = IndicatorPool->GetOrCreateInstance(
-				TSubclassOf<UUserWidget>(IndicatorWidgetClass.Get()),
-			[this, SharedInstance](UUserWidget* UserWidget)
-			{
-				if (WidgetContextSubsystem.IsValid())
-				{
-					WidgetContextSubsystem->InitializeWidget_FromHUDWidgetPool(*IndicatorPool, UserWidget, SharedInstance->WidgetContext);
-				}
-			});
-
-			if (IndicatorWidget->Implements<UHUDIndicatorWidgetInterface>())
+			if (TrackedIndicators[*TrackedIndex].State == EIndicatorState::Materialized)
 			{
-				IHUDIndicatorWidgetInterface::Execute_SetIndicator(IndicatorWidget, SharedInstance->Descriptor, SharedInstance->Component);
+				ReleaseIndicatorWidget(SlotIndices.FindChecked(&IndicatorInstance.Get()));
 			}
+			
+			// indicator that is still loading its widget class is skipped after loading
+			RemoveTrackedIndicator(*TrackedIndex);
+		}
+	}
+}
 
-			AddIndicatorSlot(SharedInstance.ToSharedRef(), IndicatorWidget)
-			[
-				SNew(SBox)
-				[
-					IndicatorWidget->TakeWidget()
-				]
-			];
+void SIndicatorCanvas::CreateIndicatorWidget(const TSharedRef<FIndicatorDescriptorInstance>& IndicatorInstance, TSubclassOf<UUserWidget> IndicatorWidgetClass)
+{
+	UUserWidget* IndicatorWidget = IndicatorPool->GetOrCreateInstance(IndicatorWidgetClass,
+	[this, &IndicatorInstance](UUserWidget* UserWidget)
+	{
+		if (WidgetContextSubsystem.IsValid())
+		{
+			WidgetContextSubsystem->InitializeWidget_FromHUDWidgetPool(*IndicatorPool, UserWidget, IndicatorInstance->WidgetContext);
 		}
 	});
-	StartAsyncLoading();
+
+	if (IndicatorWidget->Implements<UHUDIndicatorWidgetInterface>())
+	{
+		IHUDIndicatorWidgetInterface::Execute_SetIndicator(IndicatorWidget, IndicatorInstance->Descriptor, IndicatorInstance->Component);
+	}
+
+	// visibility of the slot widget is never changed, indicators are filtered during arrange
+	AddIndicatorSlot(IndicatorInstance, IndicatorWidget)
+	[
+		SNew(SBox)
+		.Visibility(EVisibility::SelfHitTestInvisible)
+		[
+			IndicatorWidget->TakeWidget()
+		]
+	];
 }
 
+void SIndicatorCanvas::ReleaseIndicatorWidget(int32 SlotIndex)
+{
+	const TWeakObjectPtr<UUserWidget> IndicatorWidget = SlotChildren[SlotIndex].GetUserWidget();
+	if (IndicatorWidget.IsValid())
+	{
+		if (IndicatorWidget->GetClass()->ImplementsInterface(UHUDIndicatorWidgetInterface::StaticClass()))
+		{
+			IHUDIndicatorWidgetInterface::Execute_ResetIndicator(IndicatorWidget.Get());
+		}
+
+		IndicatorPool->Release(IndicatorWidget.Get());
+	}
+	else
+	{
+		UE_LOG(LogIndicators, Error, TEXT("%s: Indicator widget was destroyed before slot removal!"), *FString(__FUNCTION__));
+	}
+	
+	RemoveIndicatorSlot(SlotIndex);
+}
 
-void SIndicatorCanvas::HandleIndicatorRemoved(const TSharedRef<FIndicatorDescriptorInstance>& IndicatorInstance)
+void SIndicatorCanvas::MaterializeIndicators(TConstArrayView<int32> TrackedIndexes)
 {
-	// Skip this indicator if this is not our category
-	if (!CategoryTags.HasTagExact(IndicatorInstance->Descriptor->CategoryTag))
+	// group indicators by widget class, so each class is loaded once per frame
+	// Make weak pointers. Indicators can be removed during loading
+	TMap<TSoftClassPtr<UUserWidget>, TArray<TWeakPtr<FIndicatorDescriptorInstance>>> InstancesByClass;
+	for (const int32 TrackedIndex: TrackedIndexes)
+	{
+		FTrackedIndicator& TrackedIndicator = TrackedIndicators[TrackedIndex];
+		TrackedIndicator.State = EIndicatorState::Loading;
+		
+		// Dont check on validity because of meta = (Validate)
+		InstancesByClass.FindOrAdd(TrackedIndicator.Instance->Descriptor->IndicatorWidgetClass).Add(TrackedIndicator.Instance);
+	}
+
+	if (InstancesByClass.IsEmpty())
 	{
 		return;
 	}
 	
-	for (int32 Index = 0; Index < SlotChildren.Num(); Index++)
+	for (auto& Pair: InstancesByClass)
 	{
-		if (SlotChildren[Index].GetIndicatorDescriptorInstance() == IndicatorInstance)
+		AsyncLoad(Pair.Key, [this, IndicatorWidgetClass = Pair.Key, Instances = MoveTemp(Pair.Value)]()
 		{
-			const TWeakObjectPtr<UUserWidget> IndicatorWidget = SlotChildren[Index].GetUserWidget();
-			if (IndicatorWidget.IsValid())
+			SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_CreateIndicatorWidget);
+			const TSubclassOf<UUserWidget> WidgetClass{IndicatorWidgetClass.Get()};
+			
+			for (const TWeakPtr<FIndicatorDescriptorInstance>& WeakInstance: Instances)
 			{
-				if (IndicatorWidget->GetClass()->ImplementsInterface(UHUDIndicatorWidgetInterface::StaticClass()))
+				const TSharedPtr<FIndicatorDescriptorInstance> SharedInstance = WeakInstance.Pin();
+				const int32* TrackedIndex = SharedInstance.IsValid() ? TrackedIndices.Find(SharedInstance.Get()) : nullptr;
+				
+				// indicator may have been removed during loading
+				if (TrackedIndex && TrackedIndicators[*TrackedIndex].State == EIndicatorState::Loading)
 				{
-					IHUDIndicatorWidgetInterface::Execute_ResetIndicator(IndicatorWidget.Get());
+					CreateIndicatorWidget(SharedInstance.ToSharedRef(), WidgetClass);
+					TrackedIndicators[*TrackedIndex].State = EIndicatorState::Materialized;
 				}
-
-				IndicatorPool->Release(IndicatorWidget.Get());
-			}
-			else
-			{
-				UE_LOG(LogIndicators, Error, TEXT("%s: Indicator widget was destroyed before slot removal!"), *FString(__FUNCTION__));
 			}
-			
-			RemoveIndicatorSlot(Index);
-			break;
-		}
+		});
 	}
+	StartAsyncLoading();
+}
+
+void SIndicatorCanvas::DematerializeIndicator(int32 TrackedIndex)
+{
+	FTrackedIndicator& TrackedIndicator = TrackedIndicators[TrackedIndex];
+	check(TrackedIndicator.State == EIndicatorState::Materialized);
+
+	ReleaseIndicatorWidget(SlotIndices.FindChecked(&TrackedIndicator.Instance.Get()));
+	TrackedIndicator.State = EIndicatorState::Tracked;
+}
+
+void SIndicatorCanvas::RemoveTrackedIndicator(int32 TrackedIndex)
+{
+	TrackedIndices.Remove(&TrackedIndicators[TrackedIndex].Instance.Get());
+
+	// swap with the last tracked indicator, same as indicator slots
+	const int32 LastIndex = TrackedIndicators.Num() - 1;
+	if (TrackedIndex != LastIndex)
+	{
+		Swap(TrackedIndicators[TrackedIndex], TrackedIndicators[LastIndex]);
+		TrackedIndices.Add(&TrackedIndicators[TrackedIndex].Instance.Get(), TrackedIndex);
+	}
+	TrackedIndicators.RemoveAt(LastIndex, 1, EAllowShrinking::No);
 }
 
 SIndicatorCanvas::FScopedWidgetSlotArguments SIndicatorCanvas::AddIndicatorSlot(const TSharedRef<FIndicatorDescriptorInstance>& IndicatorInstance, UUserWidget* IndicatorWidget)
 {
+	LLM_SCOPE_BYTAG(HUDFramework_IndicatorCanvas);
 	TWeakPtr<SIndicatorCanvas> WeakCanvas = SharedThis(this);
 	return FScopedWidgetSlotArguments(MakeUnique<FSlot>(IndicatorInstance, IndicatorWidget), SlotChildren, INDEX_NONE,
-		[WeakCanvas](const FSlot*, int32)
+		[WeakCanvas](const FSlot* Slot, int32 Index)
 		{
 			if (TSharedPtr<SIndicatorCanvas> Canvas = WeakCanvas.Pin())
 			{
+				Canvas->SlotIndices.Add(&Slot->GetIndicatorDescriptorInstance().Get(), Index);
 				Canvas->UpdateActiveTimer();
 			}
 		});
@@ -359,7 +791,16 @@ SIndicatorCanvas::FScopedWidgetSlotArguments SIndicatorCanvas::AddIndicatorSlot(
 
 void SIndicatorCanvas::RemoveIndicatorSlot(int32 Index)
 {
-	SlotChildren.RemoveAt(Index);
+	SlotIndices.Remove(&SlotChildren[Index].GetIndicatorDescriptorInstance().Get());
+
+	// swap with the last slot, slot order doesn't matter because slots are sorted during arrange
+	const int32 LastIndex = SlotChildren.Num() - 1;
+	if (Index != LastIndex)
+	{
+		SlotChildren.Swap(Index, LastIndex);
+		SlotIndices.Add(&SlotChildren[Index].GetIndicatorDescriptorInstance().Get(), Index);
+	}
+	SlotChildren.RemoveAt(LastIndex);
 
 	UpdateActiveTimer();
 }
@@ -373,14 +814,9 @@ void SIndicatorCanvas::SetShowAnyIndicators(bool InValue)
 
 	bShowAnyIndicators = InValue;
 
-	if (!bShowAnyIndicators)
-	{
-		for (int32 ChildIndex = 0; ChildIndex < AllChildren.Num(); ChildIndex++)
-		{
-			AllChildren.GetChildAt(ChildIndex)->SetVisibility(EVisibility::Collapsed);
-		}
-		
-	}	
+	// indicators are filtered during arrange, toggling child visibility would invalidate their layout
+	Invalidate(EInvalidateWidgetReason::Paint);
+	INC_DWORD_STAT(STAT_HUD_Framework_CanvasInvalidations);
 }
 
 void SIndicatorCanvas::OnIndicatorManagerChanged()
@@ -388,234 +824,401 @@ void SIndicatorCanvas::OnIndicatorManagerChanged()
 	// World may have changed
 	IndicatorPool->SetWorld(LocalPlayerContext.GetWorld());
 
-	IndicatorManager->OnIndicatorAdded.AddSP(this, &SIndicatorCanvas::HandleIndicatorAdded);
-	IndicatorManager->OnIndicatorRemoved.AddSP(this, &SIndicatorCanvas::HandleIndicatorRemoved);
-	for (const TSharedPtr<FIndicatorDescriptorInstance>& Instance : IndicatorManager->GetIndicators())
+	// subscribe only to our categories, manager routes indicators by category tag
+	TArray<TSharedRef<FIndicatorDescriptorInstance>> Instances;
+	for (const FGameplayTag& CategoryTag: CategoryTags)
 	{
-		HandleIndicatorAdded(Instance.ToSharedRef());
+		IndicatorManager->OnCategoryIndicatorsAdded(CategoryTag).AddSP(this, &SIndicatorCanvas::HandleIndicatorsAdded);
+		IndicatorManager->OnCategoryIndicatorsRemoved(CategoryTag).AddSP(this, &SIndicatorCanvas::HandleIndicatorsRemoved);
+
+		const TSet<TSharedPtr<FIndicatorDescriptorInstance>>& CategoryIndicators = IndicatorManager->GetIndicators(CategoryTag);
+		Instances.Reserve(Instances.Num() + CategoryIndicators.Num());
+		for (const TSharedPtr<FIndicatorDescriptorInstance>& Instance : CategoryIndicators)
+		{
+			Instances.Add(Instance.ToSharedRef());
+		}
 	}
+	HandleIndicatorsAdded(Instances);
 }
 
-bool SIndicatorCanvas::UpdateIndicators()
+bool SIndicatorCanvas::UpdateIndicators(double CurrentTime)
 {
+	SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_UpdateIndicators);
+	LLM_SCOPE_BYTAG(HUDFramework_IndicatorCanvas);
+	Private::FScopedAllocationCounter AllocationCounter{GET_STATID(STAT_HUD_Framework_UpdateAllocations)};
+	
 	bool bWasIndicatorsChanged = false;
+	[[maybe_unused]] int32 NumProjected = 0;
+	// indicators that own a widget or are loading one
+	int32 NumMaterialized = 0;
 
 	const FGeometry AllottedGeometry = CachedAllottedGeometry.GetValue();
+	const FVector2f ScreenSize = AllottedGeometry.GetLocalSize();
+
+	MaterializeCandidates.Reset();
+	DematerializeCandidates.Reset();
+	OcclusionCandidates.Reset();
 
-	for (int32 ChildIndex = 0; ChildIndex < SlotChildren.Num(); ChildIndex++)
+	// results of traces issued during previous frames
+	ReadOcclusionResults();
+
+	for (int32 TrackedIndex = 0; TrackedIndex < TrackedIndicators.Num(); TrackedIndex++)
 	{
-		FSlot& Slot = SlotChildren[ChildIndex];
-		const TSharedPtr<FIndicatorDescriptorInstance> Indicator = Slot.GetIndicatorDescriptorInstance();
+		FTrackedIndicator& TrackedIndicator = TrackedIndicators[TrackedIndex];
+		const TSharedRef<FIndicatorDescriptorInstance>& Indicator = TrackedIndicator.Instance;
+		NumMaterialized += TrackedIndicator.State != EIndicatorState::Tracked;
 
-		if (Slot.WasUserWidgetManuallyCollapsed())
+		FSlot* Slot = TrackedIndicator.State == EIndicatorState::Materialized ? &SlotChildren[SlotIndices.FindChecked(&Indicator.Get())] : nullptr;
+		if (Slot && Slot->WasUserWidgetManuallyCollapsed())
 		{
+			// widget is hidden by its owner, keep it
+			TrackedIndicator.LastVisibleTime = CurrentTime;
 			continue;
 		}
 		
-		if (Slot.WasIndicatorClampedStatusChanged())
+		FIndicatorProjectionResult Result;
+		if (Indicator->HasValidTarget())
 		{
-			Slot.ClearIndicatorClampedStatusChangedFlag();
-			bWasIndicatorsChanged = true;
+			ProjectIndicator(Indicator, ScreenSize, Result);
+			++NumProjected;
 		}
 
-		FIndicatorProjectionResult Result;
-		ProjectIndicator(Indicator.ToSharedRef(), AllottedGeometry.GetLocalSize(), Result);
-		
-		Slot.SetHasValidScreenPosition(Result.bSuccess);
+		if (Result.bSuccess)
+		{
+			TrackedIndicator.Depth = Result.ScreenPositionWithDepth.Z;
+			TrackedIndicator.WorldLocation = Result.WorldLocation;
 
-		if (Slot.HasValidScreenPosition())
+			if (Indicator->Descriptor->GetRuntimeData().OcclusionMode != EHUDIndicatorOcclusionMode::None && !TrackedIndicator.OcclusionTrace.IsValid())
+			{
+				OcclusionCandidates.Add(TrackedIndex);
+			}
+		}
+
+		const bool bVisible = IsIndicatorVisible(*Indicator, Result, ScreenSize, TrackedIndicator.bOccluded);
+		if (bVisible)
+		{
+			TrackedIndicator.LastVisibleTime = CurrentTime;
+			if (TrackedIndicator.State == EIndicatorState::Tracked)
+			{
+				MaterializeCandidates.Add(TrackedIndex);
+			}
+		}
+		else if (Slot && CurrentTime - TrackedIndicator.LastVisibleTime > Settings.DematerializeGracePeriod)
+		{
+			DematerializeCandidates.Add(TrackedIndex);
+			continue;
+		}
+
+		if (Slot == nullptr)
 		{
-			Slot.SetScreenPosition(FVector2D(Result.ScreenPositionWithDepth));
-			Slot.SetDepth(Result.ScreenPositionWithDepth.Z);
-			Slot.SetPriority(Indicator->Descriptor->Priority);
+			continue;
 		}
 		
+		Slot->SetHasValidScreenPosition(bVisible);
+
+		if (Slot->IsOccluded() != TrackedIndicator.bOccluded)
+		{
+			Slot->SetOccluded(TrackedIndicator.bOccluded);
+			const FHUDIndicatorDescriptorRuntimeData& RuntimeData = Slot->GetRuntimeData();
+			if (RuntimeData.OcclusionMode == EHUDIndicatorOcclusionMode::Dim)
+			{
+				Slot->GetWidget()->SetRenderOpacity(TrackedIndicator.bOccluded ? RuntimeData.OccludedOpacity : 1.f);
+			}
+		}
+
+		if (Slot->HasValidScreenPosition())
+		{
+			Slot->SetScreenPosition(FVector2D(Result.ScreenPositionWithDepth));
+			Slot->SetDepth(Result.ScreenPositionWithDepth.Z);
+			Slot->SetPriority(Slot->GetRuntimeData().Priority);
+		}
+	}
+
+	IssueOcclusionTraces(CurrentTime);
+	ClampIndicators(ScreenSize);
+
+	for (int32 SlotIndex = 0; SlotIndex < SlotChildren.Num(); ++SlotIndex)
+	{
+		FSlot& Slot = SlotChildren[SlotIndex];
 		bWasIndicatorsChanged |= Slot.IsDirty();
 		Slot.ClearDirtyFlag();
 	}
+
+	// release widgets of indicators that were invisible for too long
+	for (const int32 TrackedIndex: DematerializeCandidates)
+	{
+		DematerializeIndicator(TrackedIndex);
+	}
+	NumMaterialized -= DematerializeCandidates.Num();
+	bWasIndicatorsChanged |= !DematerializeCandidates.IsEmpty();
+
+	// request widgets for newly visible indicators within per frame and total budgets
+	int32 MaterializeBudget = MaterializeCandidates.Num();
+	if (Settings.MaxMaterializationsPerFrame > 0)
+	{
+		MaterializeBudget = FMath::Min(MaterializeBudget, Settings.MaxMaterializationsPerFrame);
+	}
+	if (Settings.MaxMaterializedIndicators > 0)
+	{
+		MaterializeBudget = FMath::Min(MaterializeBudget, FMath::Max(0, Settings.MaxMaterializedIndicators - NumMaterialized));
+	}
+	
+	if (MaterializeBudget > 0)
+	{
+		if (MaterializeBudget < MaterializeCandidates.Num())
+		{
+			// materialize indicators with higher priority first, closest indicators first within the same priority
+			MaterializeCandidates.Sort([this](int32 A, int32 B)
+			{
+				const FTrackedIndicator& IndicatorA = TrackedIndicators[A];
+				const FTrackedIndicator& IndicatorB = TrackedIndicators[B];
+				const int32 PriorityA = IndicatorA.Instance->Descriptor->GetRuntimeData().Priority;
+				const int32 PriorityB = IndicatorB.Instance->Descriptor->GetRuntimeData().Priority;
+				return PriorityA == PriorityB ? IndicatorA.Depth < IndicatorB.Depth : PriorityA < PriorityB;
+			});
+		}
+		
+		MaterializeIndicators(MakeArrayView(MaterializeCandidates.GetData(), MaterializeBudget));
+		NumMaterialized += MaterializeBudget;
+	}
+
+	INC_DWORD_STAT_BY(STAT_HUD_Framework_IndicatorsProjected, NumProjected);
+	INC_DWORD_STAT_BY(STAT_HUD_Framework_IndicatorsTracked, TrackedIndicators.Num());
+	INC_DWORD_STAT_BY(STAT_HUD_Framework_IndicatorsMaterialized, NumMaterialized);
+	TRACE_COUNTER_SET(HUDFramework_IndicatorsProjected, NumProjected);
+	TRACE_COUNTER_SET(HUDFramework_IndicatorsTracked, TrackedIndicators.Num());
+	TRACE_COUNTER_SET(HUDFramework_IndicatorsMaterialized, NumMaterialized);
 	
 	return bWasIndicatorsChanged;
 }
 
-uint8 SIndicatorCanvas::ClampIndicator(const FSlot& IndicatorSlot, const FVector2D& ScreenSize, FVector2D& OutClampedScreenPosition) const
+bool SIndicatorCanvas::IsIndicatorVisible(const FIndicatorDescriptorInstance& Instance, const FIndicatorProjectionResult& Result, const FVector2f& ScreenSize, bool bOccluded) const
 {
-	Private::EDirection ClampDirection = Private::EDirection::MAX;
-	const Private::FSlotSizeAndOffset Params(IndicatorSlot, true);
-
-	const FVector2D ArrowImageSize = ArrowBrush->GetImageSize();
-	const FIntPoint FixedPadding = MinClampPadding + FIntPoint(ArrowImageSize.X, ArrowImageSize.Y);
-	const FIntPoint RectMin = FIntPoint(Params.PaddingMin.X, Params.PaddingMin.Y) + FixedPadding;
-	const FIntPoint RectMax = FIntPoint(ScreenSize.X - Params.PaddingMax.X, ScreenSize.Y - Params.PaddingMax.Y) - FixedPadding;
-	const FIntRect ClampRect = FIntRect(RectMin, RectMax);
-	const FVector Center = FVector(ScreenSize * 0.5f, 0.f);
+	if (!Result.bSuccess)
+	{
+		return false;
+	}
 
-	const FVector2D CurrentScreenPosition = IndicatorSlot.GetScreenPosition();
+	const FHUDIndicatorDescriptorRuntimeData& RuntimeData = Instance.Descriptor->GetRuntimeData();
+	if (bOccluded && RuntimeData.OcclusionMode == EHUDIndicatorOcclusionMode::Hide)
+	{
+		return false;
+	}
+	
+	if (RuntimeData.MaxDistance > 0.f && Result.ScreenPositionWithDepth.Z > RuntimeData.MaxDistance)
+	{
+		return false;
+	}
 
-	if (!ClampRect.Contains(FIntPoint(CurrentScreenPosition.X, CurrentScreenPosition.Y)))
+	if (!RuntimeData.HasAnyFlags(EHUDIndicatorDescriptorFlags::DisplayWhenCannotRender) && !Instance.IsPositional() && !Instance.Component->CanEverRender())
 	{
-		const FPlane Planes[] =
-		{
-			FPlane(FVector(1.f, 0.f, 0.f), ClampRect.Min.X), //Left
-			FPlane(FVector(0.f, 1.f, 0.f), ClampRect.Min.Y), // Top
-			FPlane(FVector(-1.f, 0.f, 0.f), -ClampRect.Max.X), //Right
-			FPlane(FVector(0.f, -1.f, 0.f), -ClampRect.Max.Y) //Bottom
-		};
-		
-		FVector OutIntersectionPoint = FVector::ZeroVector;
-		for (int32 Index = 0; Index < static_cast<int32>(Private::EDirection::MAX); ++Index)
-		{
-			bool bSuccess = FMath::SegmentPlaneIntersection(
-				Center,
-				FVector(CurrentScreenPosition, 0.f),
-				Planes[Index],
-				OutIntersectionPoint);
+		return false;
+	}
 
-			bSuccess &= FIntRect(RectMin - 1, RectMax + 1).Contains(FIntPoint(OutIntersectionPoint.X, OutIntersectionPoint.Y));
-			
-			if (bSuccess)
-			{
-				ClampDirection = static_cast<Private::EDirection>(Index);
-				OutClampedScreenPosition = FVector2D(OutIntersectionPoint);
-			}
-		}
+	// clamped indicators are always on the screen
+	const bool bSkipClamp = bOccluded && RuntimeData.OcclusionMode == EHUDIndicatorOcclusionMode::SkipClamp;
+	if (!RuntimeData.HasAnyFlags(EHUDIndicatorDescriptorFlags::ClampToScreen) || bSkipClamp)
+	{
+		const FVector2D Margin{Settings.OffscreenMargin};
+		return FBox2D{-Margin, FVector2D{ScreenSize} + Margin}.IsInsideOrOn(FVector2D{Result.ScreenPositionWithDepth});
 	}
 	
-	return static_cast<uint8>(ClampDirection);
+	return true;
 }
 
-SIndicatorCanvas::FScopedArrowChildren::~FScopedArrowChildren()
+void SIndicatorCanvas::ReadOcclusionResults()
 {
-	int32 InactiveArrows = 0;
-	// Disable all arrows that dont use
-	while (Index < ArrowChildren.Num())
+	UWorld* World = LocalPlayerContext.GetWorld();
+	if (World == nullptr)
 	{
-		// Check max number of inactive arrows reached.
-		if (InactiveArrows == MAX_INACTIVE_ARROWS)
+		return;
+	}
+
+	FTraceDatum TraceDatum;
+	for (FTrackedIndicator& TrackedIndicator: TrackedIndicators)
+	{
+		if (!TrackedIndicator.OcclusionTrace.IsValid())
 		{
-			// Remove arrow slot. Dont increment index in removal operation.
-			ArrowChildren.RemoveAt(Index);
 			continue;
 		}
-
-		//Deactivate arrow widget and increment Index.
-		ArrowChildren.GetChildAt(Index++)->SetVisibility(EVisibility::Collapsed);
-		InactiveArrows++;
+		
+		if (World->QueryTraceData(TrackedIndicator.OcclusionTrace, TraceDatum))
+		{
+			TrackedIndicator.bOccluded = TraceDatum.OutHits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+			TrackedIndicator.OcclusionTrace.Invalidate();
+		}
+		else if (!World->IsTraceHandleValid(TrackedIndicator.OcclusionTrace, false))
+		{
+			// trace results expired before they were read, indicator will be traced again
+			TrackedIndicator.OcclusionTrace.Invalidate();
+		}
 	}
 }
 
-TSharedRef<SIndicatorCanvasArrowWidget> SIndicatorCanvas::FScopedArrowChildren::GetOrCreateArrowChild()
+void SIndicatorCanvas::IssueOcclusionTraces(double CurrentTime)
 {
-	if (Index < ArrowChildren.Num())
+	UWorld* World = LocalPlayerContext.GetWorld();
+	APlayerController* PlayerController = LocalPlayerContext.GetPlayerController();
+	if (OcclusionCandidates.IsEmpty() || World == nullptr || PlayerController == nullptr)
 	{
-		return StaticCastSharedRef<SIndicatorCanvasArrowWidget>(ArrowChildren.GetChildAt(Index++));
+		return;
 	}
 
-	if (Index == ArrowChildren.Num())
+	int32 TraceBudget = OcclusionCandidates.Num();
+	if (Settings.MaxOcclusionTracesPerFrame > 0 && Settings.MaxOcclusionTracesPerFrame < TraceBudget)
 	{
-		TSharedRef<SIndicatorCanvasArrowWidget> NewArrowWidget = SNew(SIndicatorCanvasArrowWidget, ArrowBrush);
-		NewArrowWidget->SetVisibility(EVisibility::Collapsed);
+		TraceBudget = Settings.MaxOcclusionTracesPerFrame;
+		
+		// indicators are traced in rotation by time since their last trace
+		// near and high priority indicators accumulate urgency faster, so they are traced more often
+		const double FalloffDistance = Settings.OcclusionFalloffDistance;
+		auto GetUrgency = [CurrentTime, FalloffDistance](const FTrackedIndicator& TrackedIndicator)
+		{
+			const double Staleness = CurrentTime - TrackedIndicator.LastOcclusionTestTime;
+			const double DepthWeight = FalloffDistance / (FalloffDistance + TrackedIndicator.Depth);
+			const double PriorityWeight = 1.0 / (1.0 + TrackedIndicator.Instance->Descriptor->GetRuntimeData().Priority);
+			return Staleness * DepthWeight * PriorityWeight;
+		};
+		
+		OcclusionCandidates.Sort([this, &GetUrgency](int32 A, int32 B)
+		{
+			return GetUrgency(TrackedIndicators[A]) > GetUrgency(TrackedIndicators[B]);
+		});
+	}
 
-		ArrowChildren.AddSlot(MoveTemp(FArrowSlot::FSlotArguments(MakeUnique<FArrowSlot>())
-		[
-			NewArrowWidget
-		]));
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	APawn* Pawn = PlayerController->GetPawn();
+	FCollisionQueryParams QueryParams{SCENE_QUERY_STAT(HUDIndicatorOcclusion), false, Pawn};
+
+	for (int32 Index = 0; Index < TraceBudget; ++Index)
+	{
+		FTrackedIndicator& TrackedIndicator = TrackedIndicators[OcclusionCandidates[Index]];
+		const FIndicatorDescriptorInstance& Indicator = *TrackedIndicator.Instance;
 
-		Index++;
+		// indicator target shouldn't occlude itself
+		if (!Indicator.IsPositional())
+		{
+			QueryParams.AddIgnoredActor(Indicator.Component->GetOwner());
+		}
+		TrackedIndicator.OcclusionTrace = World->AsyncLineTraceByChannel(EAsyncTraceType::Single,
+			ViewLocation, TrackedIndicator.WorldLocation, Indicator.Descriptor->OcclusionTraceChannel, QueryParams);
+		TrackedIndicator.LastOcclusionTestTime = CurrentTime;
 
-		return NewArrowWidget;
+		QueryParams.ClearIgnoredActors();
+		QueryParams.AddIgnoredActor(Pawn);
 	}
 
-	// Should never happen
-	checkf(false, TEXT("%s: Index out of range!"), *FString(__FUNCTION__));
-	return TSharedPtr<SIndicatorCanvasArrowWidget>().ToSharedRef();
+	INC_DWORD_STAT_BY(STAT_HUD_Framework_OcclusionTraces, TraceBudget);
+	TRACE_COUNTER_SET(HUDFramework_OcclusionTraces, TraceBudget);
 }
 
-void SIndicatorCanvas::AddArrowWidget(const FGeometry& AllottedGeometry, FArrangedChildren& ToArrangedChildren, FScopedArrowChildren& FromScopedChildren, uint8 InArrowDirection, const FVector2D& IndicatorPosition, const FVector2D& IndicatorSize, EVerticalAlignment IndicatorVAlignment) const
+void SIndicatorCanvas::ClampIndicators(const FVector2f& ScreenSize)
 {
-	const Private::EDirection ArrowDirection = static_cast<Private::EDirection>(InArrowDirection);
-	const FVector2D ArrowOffsetDirection = Private::ArrowOffsets[int32(ArrowDirection)];
-	const float ArrowRotation = Private::ArrowRotations[int32(ArrowDirection)];
-	const FVector2D ArrowWidgetSize = ArrowBrush->GetImageSize();
+	[[maybe_unused]] int32 NumClamped = 0;
 
-	// Calculating arrow position
-	const FVector2D WidgetOffset = (IndicatorSize + ArrowWidgetSize) * 0.5f * ArrowOffsetDirection;
-	const FVector2D ArrowCenteringOffset = -(ArrowWidgetSize * 0.5f);
-	FVector2D ArrowAlignmentOffset = FVector2D::ZeroVector;
-	switch (IndicatorVAlignment)
+	ClampBatch.Reset();
+	for (int32 SlotIndex = 0; SlotIndex < SlotChildren.Num(); ++SlotIndex)
 	{
-	case VAlign_Top:
-		ArrowAlignmentOffset = IndicatorSize * FVector2D(0.f, 0.5f);
-		break;
-	case VAlign_Bottom:
-		ArrowAlignmentOffset = IndicatorSize * FVector2D(0.f, -0.5f);
-		break;
-	default: break;
-	}
-	const FVector2D FinalOffset = WidgetOffset + ArrowAlignmentOffset + ArrowCenteringOffset;
-	const FVector2D FinalPosition = IndicatorPosition + FinalOffset;
-
-	// Grab arrow from scoped children
-	const TSharedRef<SIndicatorCanvasArrowWidget> ArrowWidget = FromScopedChildren.GetOrCreateArrowChild();
-	ArrowWidget->SetRotation(ArrowRotation);
-	ArrowWidget->SetVisibility(EVisibility::HitTestInvisible);
+		FSlot& Slot = SlotChildren[SlotIndex];
+		const UHUDIndicatorDescriptor* Descriptor = Slot.GetIndicatorDescriptorInstance()->Descriptor;
+		const FHUDIndicatorDescriptorRuntimeData& RuntimeData = Descriptor->GetRuntimeData();
 
-	const FLayoutGeometry Geometry(FSlateLayoutTransform(1.f, FinalPosition), ArrowWidgetSize);
-	ToArrangedChildren.AddWidget(AllottedGeometry.MakeChild(ArrowWidget, Geometry));
-}
+		// occluded indicators may opt out of clamping
+		const bool bSkipClamp = Slot.IsOccluded() && RuntimeData.OcclusionMode == EHUDIndicatorOcclusionMode::SkipClamp;
+		if (!RuntimeData.HasAnyFlags(EHUDIndicatorDescriptorFlags::ClampToScreen) || bSkipClamp || !Slot.HasValidScreenPosition() || Slot.WasUserWidgetManuallyCollapsed())
+		{
+			Slot.SetWasIndicatorClamped(false);
+			continue;
+		}
 
-Private::FSlotSizeAndOffset::FSlotSizeAndOffset(const SIndicatorCanvas::FSlot& IndicatorSlot, bool bApplyScale)
-{
-	const float Scale = bApplyScale ? IndicatorSlot.GetIndicatorScale() : 1.f;
-	
-	// Grab box from FSlot. Conversation from TSharedRef, object must be valid
-	Size = IndicatorSlot.GetWidget()->GetDesiredSize() * Scale;
-	const UHUDIndicatorDescriptor* Descriptor = IndicatorSlot.GetIndicatorDescriptorInstance()->Descriptor;
+		// clamp rectangle depends on indicator size, alignment and arrow size
+		const Private::FSlotSizeAndOffset Params(Slot, true);
+		const FSlateBrush* IndicatorArrowBrush = GetArrowBrush(Descriptor);
+		const FVector2D ArrowImageSize = IndicatorArrowBrush ? IndicatorArrowBrush->GetImageSize() : FVector2D::ZeroVector;
+		const FVector2D FixedPadding = FVector2D(MinClampPadding) + ArrowImageSize;
+		const FVector2D RectMin = Params.PaddingMin + FixedPadding;
+		const FVector2D RectMax = FVector2D(ScreenSize) - Params.PaddingMax - FixedPadding;
+		const FVector2D Extent = FVector2D::Max((RectMax - RectMin) * 0.5, FVector2D{1.0});
+		
+		ClampBatch.Add(SlotIndex, FVector2f{Slot.GetScreenPosition()}, FVector2f{(RectMin + RectMax) * 0.5}, FVector2f{Extent});
+	}
+	ClampBatch.PrepareOutputs();
 
-	switch (Descriptor->HorizontalAlignment)
+	switch (Settings.ClampShape)
 	{
-	case HAlign_Left:
-		Offset.X = 0.f;
-		PaddingMin.X = 0.f;
-		PaddingMax.X = Size.X;
+	case EHUDIndicatorClampShape::Rectangle:
+		Private::ClampToRectangle(ClampBatch);
 		break;
-
-	case HAlign_Fill:
-	case HAlign_Center:
-		Offset.X = -Size.X / 2.f;
-		PaddingMin.X = Size.X / 2.f;
-		PaddingMax.X = PaddingMin.X;
+	case EHUDIndicatorClampShape::RoundedRectangle:
+		Private::ClampToRoundedRectangle(ClampBatch, Settings.ClampCornerRadius);
 		break;
-		
-	case HAlign_Right:
-		Offset.X = -Size.X;
-		PaddingMin.X = Size.X;
-		PaddingMax.X = 0.f;
+	case EHUDIndicatorClampShape::Ellipse:
+		Private::ClampToEllipse(ClampBatch);
 		break;
-		
 	default: checkNoEntry();
 	}
 
-	switch (Descriptor->VerticalAlignment)
+	for (int32 Index = 0; Index < ClampBatch.Num(); ++Index)
 	{
-	case VAlign_Top:
-		Offset.Y = 0.f;
-		PaddingMin.Y = 0.f;
-		PaddingMax.Y = Size.Y;
-		break;
-
-	case VAlign_Fill:
-	case VAlign_Center:
-		Offset.Y = -Size.Y / 2.f;
-		PaddingMin.Y = Size.Y / 2.f;
-		PaddingMax.Y = PaddingMin.Y;
-		break;
+		FSlot& Slot = SlotChildren[ClampBatch.SlotIndexes[Index]];
 		
-	case VAlign_Bottom:
-		Offset.Y = -Size.Y;
-		PaddingMin.Y = Size.Y;
-		PaddingMax.Y = 0.f;
-		break;
-		
-	default: checkNoEntry();
+		const bool bWasIndicatorClamped = static_cast<Private::EDirection>(ClampBatch.Directions[Index]) != Private::EDirection::MAX;
+		Slot.SetWasIndicatorClamped(bWasIndicatorClamped);
+		if (bWasIndicatorClamped)
+		{
+			Slot.SetClampedScreenPosition(FVector2D{ClampBatch.ClampedPositions[Index]});
+			Slot.SetClampDirection(ClampBatch.Directions[Index]);
+			Slot.SetArrowRotation(ClampBatch.Rotations[Index]);
+			++NumClamped;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_HUD_Framework_IndicatorsClamped, NumClamped);
+	TRACE_COUNTER_SET(HUDFramework_IndicatorsClamped, NumClamped);
+}
+
+const FSlateBrush* SIndicatorCanvas::GetArrowBrush(const UHUDIndicatorDescriptor* Descriptor) const
+{
+	return Descriptor->GetRuntimeData().HasAnyFlags(EHUDIndicatorDescriptorFlags::OverrideArrowBrush) ? &Descriptor->ArrowBrush : ArrowBrush;
+}
+
+void SIndicatorCanvas::AddArrow(const FSlateBrush* Brush, uint8 InArrowDirection, float ArrowRotation, const FVector2D& IndicatorPosition, const FVector2D& IndicatorSize, float IndicatorVAlignment) const
+{
+	if (Brush == nullptr)
+	{
+		return;
 	}
+	
+	const Private::EDirection ArrowDirection = static_cast<Private::EDirection>(InArrowDirection);
+	const FVector2D ArrowOffsetDirection = Private::ArrowOffsets[int32(ArrowDirection)];
+	const FVector2D ArrowSize = Brush->GetImageSize();
+
+	// Calculating arrow position
+	const FVector2D WidgetOffset = (IndicatorSize + ArrowSize) * 0.5f * ArrowOffsetDirection;
+	const FVector2D ArrowCenteringOffset = -(ArrowSize * 0.5f);
+	// move arrow to the indicator center
+	const FVector2D ArrowAlignmentOffset = IndicatorSize * FVector2D(0.f, 0.5f - IndicatorVAlignment);
+	const FVector2D FinalOffset = WidgetOffset + ArrowAlignmentOffset + ArrowCenteringOffset;
+
+	FArrowInstance& Arrow = ArrowInstances.AddDefaulted_GetRef();
+	Arrow.Position = IndicatorPosition + FinalOffset;
+	Arrow.Rotation = ArrowRotation;
+	Arrow.Brush = Brush;
+}
+
+Private::FSlotSizeAndOffset::FSlotSizeAndOffset(const SIndicatorCanvas::FSlot& IndicatorSlot, bool bApplyScale)
+{
+	const float Scale = bApplyScale ? IndicatorSlot.GetIndicatorScale() : 1.f;
+	
+	// Grab box from FSlot. Conversation from TSharedRef, object must be valid
+	Size = IndicatorSlot.GetWidget()->GetDesiredSize() * Scale;
+	
+	// alignment factors are precomputed by the descriptor
+	const FVector2D Alignment{IndicatorSlot.GetRuntimeData().Alignment};
+	Offset = -Size * Alignment;
+	PaddingMin = Size * Alignment;
+	PaddingMax = Size - PaddingMin;
 }
@@ -38,9 +38,31 @@ void UIndicatorProjectionMode_ComponentPoint::Project(const USceneComponent* Com
 	const FVector2D ScreenSpacePosition = CalculateScreenPosition(ViewProjectionData, WorldLocation, ScreenSize, ScreenSpaceOffset);
 	
 	Result.ScreenPositionWithDepth = FVector(ScreenSpacePosition.X, ScreenSpacePosition.Y, FVector::Dist(ViewProjectionData.ViewOrigin, WorldLocation));
+	Result.WorldLocation = WorldLocation;
 	Result.bSuccess = true;
 }
 
+void UIndicatorProjectionMode_ComponentPoint::ProjectPoint(const FVector& WorldLocation, const FVector& WorldLocationOffset, const FVector2D& ScreenSpaceOffset, const FLocalPlayerContext& PlayerContext, const FVector2f& ScreenSize, FIndicatorProjectionResult& Result)
+{
+	FSceneViewProjectionData ViewProjectionData;
+	if (!GetProjectionData(PlayerContext, ViewProjectionData))
+	{
+		return;
+	}
+
+	const FVector OffsetLocation = WorldLocation + WorldLocationOffset;
+	const FVector2D ScreenSpacePosition = CalculateScreenPosition(ViewProjectionData, OffsetLocation, ScreenSize, ScreenSpaceOffset);
+	
+	Result.ScreenPositionWithDepth = FVector(ScreenSpacePosition.X, ScreenSpacePosition.Y, FVector::Dist(ViewProjectionData.ViewOrigin, OffsetLocation));
+	Result.WorldLocation = OffsetLocation;
+	Result.bSuccess = true;
+}
+
+void UIndicatorProjectionMode_ComponentPoint::ProjectWorldLocation(const FVector& WorldLocation, const FLocalPlayerContext& PlayerContext, const FVector2f& ScreenSize, FIndicatorProjectionResult& Result) const
+{
+	ProjectPoint(WorldLocation, WorldLocationOffset, ScreenSpaceOffset, PlayerContext, ScreenSize, Result);
+}
+
 void UIndicatorProjectionMode_ComponentBoundingBox::Project(const USceneComponent* Component, const FName& SocketName, const FLocalPlayerContext& PlayerContext, const FVector2f& ScreenSize, FIndicatorProjectionResult& Result) const
 {
 	if (!Validate(Component, SocketName, PlayerContext))
@@ -64,5 +86,11 @@ void UIndicatorProjectionMode_ComponentBoundingBox::Project(const USceneComponen
 	const FVector2D ScreenSpacePosition = UIndicatorProjectionMode_ComponentPoint::CalculateScreenPosition(ViewProjectionData, WorldLocation, ScreenSize, ScreenSpaceOffset);
 
 	Result.ScreenPositionWithDepth = FVector(ScreenSpacePosition.X, ScreenSpacePosition.Y, FVector::Dist(ViewProjectionData.ViewOrigin, WorldLocation));
+	Result.WorldLocation = WorldLocation;
 	Result.bSuccess = true;
 }
+
+void UIndicatorProjectionMode_ComponentBoundingBox::ProjectWorldLocation(const FVector& WorldLocation, const FLocalPlayerContext& PlayerContext, const FVector2f& ScreenSize, FIndicatorProjectionResult& Result) const
+{
+	UIndicatorProjectionMode_ComponentPoint::ProjectPoint(WorldLocation, WorldLocationOffset, ScreenSpaceOffset, PlayerContext, ScreenSize, Result);
+}
\ No newline at end of file
@@ -11,12 +11,18 @@
 #include "ViewModel/HUDViewModel.h"
 #include "ViewModel/HUDWidgetContextExtension.h"
 #include "ViewModel/HUDWidgetContextInterface.h"
+#include "ProfilingDebugging/CountersTrace.h"
 
 DECLARE_CYCLE_STAT(TEXT("InitializeWidgetTree"),	STAT_HUD_Framework_InitializeWidgetTree, STATGROUP_HUD_Framework);
 DECLARE_CYCLE_STAT(TEXT("InitializeWidget"),		STAT_HUD_Framework_InitializeWidget,	STATGROUP_HUD_Framework);
 DECLARE_CYCLE_STAT(TEXT("CreateViewModel"),			STAT_HUD_Framework_CreateViewModel,		STATGROUP_HUD_Framework);
 DECLARE_CYCLE_STAT(TEXT("ReleaseViewModel"),		STAT_HUD_Framework_ReleaseViewModel,	STATGROUP_HUD_Framework);
 DECLARE_CYCLE_STAT(TEXT("TickViewModels"),			STAT_HUD_Framework_TickModels,			STATGROUP_HUD_Framework);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("ViewModels Live"),	STAT_HUD_Framework_ViewModelsLive,		STATGROUP_HUD_Framework);
+DECLARE_DWORD_COUNTER_STAT(TEXT("ViewModels Ticked"),	STAT_HUD_Framework_ViewModelsTicked,	STATGROUP_HUD_Framework);
+
+TRACE_DECLARE_INT_COUNTER(HUDFramework_ViewModelsLive,		TEXT("HUDFramework/ViewModelsLive"));
+TRACE_DECLARE_INT_COUNTER(HUDFramework_ViewModelsTicked,	TEXT("HUDFramework/ViewModelsTicked"));
 
 UHUDWidgetContextSubsystem* UHUDWidgetContextSubsystem::Get(const UObject* WorldContextObject)
 {
@@ -233,7 +239,7 @@ const UUserWidget* UHUDWidgetContextSubsystem::GetActiveWidgetTreeForWidget(cons
 void UHUDWidgetContextSubsystem::InitializeWidgetTree(UUserWidget* UserWidget)
 {
 	check(UserWidget);
-	SCOPE_CYCLE_COUNTER(STAT_HUD_Framework_InitializeWidgetTree);
+	SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_InitializeWidgetTree);
 	
 	TArray<UUserWidget*, TInlineAllocator<80>> WidgetsToInitialize;
 	WidgetsToInitialize.Add(UserWidget);
@@ -279,7 +285,8 @@ void UHUDWidgetContextSubsystem::InitializeWidgetTree(UUserWidget* UserWidget)
 
 void UHUDWidgetContextSubsystem::InitializeWidgetInternal(UUserWidget* UserWidget, UHUDWidgetContextExtension* Extension)
 {
-	SCOPE_CYCLE_COUNTER(STAT_HUD_Framework_InitializeWidget);
+	SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_InitializeWidget);
+	LLM_SCOPE_BYTAG(HUDFramework_ViewModels);
 
 	check(UserWidget);
 	if (UMVVMView* View = UserWidget->GetExtension<UMVVMView>())
@@ -338,10 +345,13 @@ bool UHUDWidgetContextSubsystem::IsWidgetRegistered(const UUserWidget* UserWidge
 
 UHUDViewModel* UHUDWidgetContextSubsystem::CreateViewModel(const UUserWidget* UserWidget, const UUserWidget* ContextWidget, TSubclassOf<UHUDViewModel> ViewModelClass)
 {
-	SCOPE_CYCLE_COUNTER(STAT_HUD_Framework_CreateViewModel);
+	SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_CreateViewModel);
+	LLM_SCOPE_BYTAG(HUDFramework_ViewModels);
 	
 	// @todo: view model pooling
 	UHUDViewModel* ViewModel = NewObject<UHUDViewModel>(this, ViewModelClass);
+	INC_DWORD_STAT(STAT_HUD_Framework_ViewModelsLive);
+	TRACE_COUNTER_INCREMENT(HUDFramework_ViewModelsLive);
 	FHUDWidgetContextHandle WidgetContext = GetWidgetContext(UserWidget);
 
 #if WITH_EDITOR
@@ -365,7 +375,10 @@ UHUDViewModel* UHUDWidgetContextSubsystem::CreateViewModel(const UUserWidget* Us
 
 void UHUDWidgetContextSubsystem::ReleaseViewModel(const UUserWidget* UserWidget, UHUDViewModel* ViewModel)
 {
-	SCOPE_CYCLE_COUNTER(STAT_HUD_Framework_ReleaseViewModel);
+	SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_ReleaseViewModel);
+	// view model is marked as garbage either way
+	DEC_DWORD_STAT(STAT_HUD_Framework_ViewModelsLive);
+	TRACE_COUNTER_DECREMENT(HUDFramework_ViewModelsLive);
 	
 	FHUDWidgetContextHandle WidgetContext = GetWidgetContext(UserWidget);
 
@@ -399,14 +412,19 @@ void UHUDWidgetContextSubsystem::TickModels(float DeltaTime)
 		return;
 	}
 	
-	SCOPE_CYCLE_COUNTER(STAT_HUD_Framework_TickModels);
+	SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(STAT_HUD_Framework_TickModels);
 	SCOPED_NAMED_EVENT(UHUDViewModelSubsystem_Tick, FColor::Turquoise)
 
+	[[maybe_unused]] int32 NumTicked = 0;
 	for (UHUDViewModel* TickableModel: TickableModels)
 	{
 		if (TickableModel->IsTickable())
 		{
 			TickableModel->Tick(DeltaTime);
+			++NumTicked;
 		}
 	}
+	
+	INC_DWORD_STAT_BY(STAT_HUD_Framework_ViewModelsTicked, NumTicked);
+	TRACE_COUNTER_SET(HUDFramework_ViewModelsTicked, NumTicked);
 }
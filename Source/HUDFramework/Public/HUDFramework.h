@@ -1,9 +1,30 @@
 ﻿#pragma once
 
 #include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
 #include "Modules/ModuleManager.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
 
 HUDFRAMEWORK_API DECLARE_LOG_CATEGORY_EXTERN(LogHUDFramework, Log, All);
 DECLARE_LOG_CATEGORY_EXTERN(LogIndicators, Log, All);
 
-DECLARE_STATS_GROUP(TEXT("HUD Framework"), STATGROUP_HUD_Framework, STATCAT_Advanced)
\ No newline at end of file
+DECLARE_STATS_GROUP(TEXT("HUD Framework"), STATGROUP_HUD_Framework, STATCAT_Advanced)
+
+/** Low level memory tracker tags, run with -llm and use 'stat LLMFULL' or Unreal Insights memory view */
+LLM_DECLARE_TAG_API(HUDFramework, HUDFRAMEWORK_API);
+LLM_DECLARE_TAG_API(HUDFramework_IndicatorCanvas, HUDFRAMEWORK_API);
+LLM_DECLARE_TAG_API(HUDFramework_WidgetPool, HUDFRAMEWORK_API);
+LLM_DECLARE_TAG_API(HUDFramework_WidgetPool_Objects, HUDFRAMEWORK_API);
+LLM_DECLARE_TAG_API(HUDFramework_WidgetPool_Slate, HUDFRAMEWORK_API);
+LLM_DECLARE_TAG_API(HUDFramework_WidgetContexts, HUDFRAMEWORK_API);
+LLM_DECLARE_TAG_API(HUDFramework_ViewModels, HUDFRAMEWORK_API);
+LLM_DECLARE_TAG_API(HUDFramework_LayoutRegistry, HUDFRAMEWORK_API);
+
+/** Unreal Insights channel for HUD Framework events, enable with -trace=cpu,counters,HUDFramework */
+UE_TRACE_CHANNEL_EXTERN(HUDFrameworkChannel, HUDFRAMEWORK_API);
+
+/** Cycle stat scope, also reported as cpu event on HUDFramework trace channel */
+#define SCOPE_HUD_FRAMEWORK_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, HUDFrameworkChannel)
\ No newline at end of file
@@ -17,5 +17,9 @@ public:
 
 	UPROPERTY(EditDefaultsOnly, Config, meta = (Validate))
 	TSoftClassPtr<UHUDLayoutPolicy> PolicyClass;
+
+	/** Max number of asynchronously loaded layout extension widgets created per frame, 0 means no limit */
+	UPROPERTY(EditDefaultsOnly, Config, meta = (ClampMin = 0))
+	int32 ExtensionWidgetsPerFrame = 4;
 	
 };
@@ -15,11 +15,52 @@ public:
 	FGameplayTag SlotTag;
 	TWeakObjectPtr<const ULocalPlayer> PlayerContext;
 	TSubclassOf<UUserWidget> WidgetClass;
+	/** widget class loaded by slots on demand, set if extension was registered with a soft class */
+	TSoftClassPtr<UUserWidget> SoftWidgetClass;
 	/** kept alive in UHUDLayoutSubsystem::AddReferencedObjects */
 	FHUDWidgetContextHandle WidgetContext;
+	/** assigned by layout tag index, defines notification order. Zero if extension is not registered */
+	uint64 RegistrationId = 0;
+	/** registered during extension batch, slots are not notified yet */
+	bool bPendingNotify = false;
 	
 	FHUDLayoutExtension() = default;
 	FHUDLayoutExtension(const FGameplayTag& InSlotTag, TSubclassOf<UUserWidget> InWidgetClass, const ULocalPlayer* InLocalPlayer, const FHUDWidgetContextHandle& InContext);
+	FHUDLayoutExtension(const FGameplayTag& InSlotTag, const TSoftClassPtr<UUserWidget>& InWidgetClass, const ULocalPlayer* InLocalPlayer, const FHUDWidgetContextHandle& InContext);
+
+	/** @return whether extension has a widget class, loaded or not */
+	FORCEINLINE bool HasWidgetClass() const
+	{
+		return WidgetClass.Get() != nullptr || !SoftWidgetClass.IsNull();
+	}
+
+	FORCEINLINE bool IsRegistered() const
+	{
+		return RegistrationId != 0;
+	}
+
+	/** @return widget class path, regardless of whether class is loaded */
+	FSoftObjectPath GetWidgetClassPath() const;
+
+	/** @return true if extensions produce the same widget for the same slots: same slot tag, player, widget class and identical widget context */
+	bool IsEquivalent(const FHUDLayoutExtension& Other) const;
+};
+
+/** Layout extension description for batched registration */
+struct FHUDLayoutExtensionParams
+{
+	FHUDLayoutExtensionParams() = default;
+	FHUDLayoutExtensionParams(const FGameplayTag& InSlotTag, TSubclassOf<UUserWidget> InWidgetClass, const FHUDWidgetContextHandle& InContext = FHUDWidgetContextHandle{})
+		: SlotTag(InSlotTag)
+		, WidgetClass(InWidgetClass)
+		, WidgetContext(InContext)
+	{}
+	
+	FGameplayTag SlotTag;
+	TSubclassOf<UUserWidget> WidgetClass;
+	/** used if @WidgetClass is not set, slots load widget class asynchronously */
+	TSoftClassPtr<UUserWidget> SoftWidgetClass;
+	FHUDWidgetContextHandle WidgetContext;
 };
 
 USTRUCT(BlueprintType)
@@ -86,6 +127,10 @@ struct HUDFRAMEWORK_API FHUDLayoutExtensionRequest
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	TSubclassOf<UUserWidget> WidgetClass;
 
+	/** set if widget class should be loaded before creating extension widget */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSoftClassPtr<UUserWidget> SoftWidgetClass;
+
 	UPROPERTY()
 	FHUDWidgetContextHandle WidgetContext;
 };
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 class ULocalPlayer;
 class UHUDPrimaryLayout;
+struct FStreamableHandle;
 
 USTRUCT()
 struct FHUDPrimaryLayoutInstance
@@ -56,10 +57,24 @@ public:
 	virtual void NotifyPlayerAdded(ULocalPlayer* LocalPlayer);
 	virtual void NotifyPlayerRemoved(ULocalPlayer* LocalPlayer);
 
+	/** Start loading primary layout class, primary layouts for local players are created once it is loaded */
+	TSharedPtr<FStreamableHandle> PreloadPrimaryLayout();
+
+	/** @return true if primary layout class is loaded and primary layout can be created without blocking */
+	bool IsPrimaryLayoutClassLoaded() const;
+
 protected:
 
+	void HandlePrimaryLayoutClassLoaded();
+
 	void OnPlayerControllerChanged(APlayerController* PlayerController, ULocalPlayer* LocalPlayer);
 
+	/** @return true if existing primary layout can be kept for a new player controller */
+	virtual bool CanKeepPrimaryLayout(const FHUDPrimaryLayoutInstance& LayoutInstance, APlayerController* PlayerController) const;
+	
+	/** Re-own existing primary layout by the new player controller and refresh its player context */
+	void KeepPrimaryLayout(FHUDPrimaryLayoutInstance& LayoutInstance, APlayerController* PlayerController);
+
 	virtual UWorld* GetWorld() const override;
 	
 	void AddPrimaryLayout(ULocalPlayer* LocalPlayer);
@@ -67,6 +82,7 @@ protected:
 
 	virtual void OnPrimaryLayoutAdded(ULocalPlayer* LocalPlayer, UHUDPrimaryLayout* Layout);
 	virtual void OnPrimaryLayoutRemoved(ULocalPlayer* LocalPlayer, UHUDPrimaryLayout* Layout);
+	virtual void OnPrimaryLayoutKept(ULocalPlayer* LocalPlayer, UHUDPrimaryLayout* Layout);
 
 	UHUDPrimaryLayout* CreatePrimaryLayout(ULocalPlayer* LocalPlayer) const;
 
@@ -74,7 +90,21 @@ protected:
 	UPROPERTY(EditAnywhere, meta = (Validate))
 	TSoftClassPtr<UHUDPrimaryLayout> PrimaryLayoutClass;
 
+	/**
+	 * If set, primary layout is kept when local player changes player controller (possession, seamless travel)
+	 * Layout is re-owned by the new player controller instead of being recreated, so layers, slots and extensions survive
+	 * Layout is still recreated if primary layout class has changed
+	 */
+	UPROPERTY(EditAnywhere)
+	bool bKeepLayoutOnControllerChange = false;
+
 	/** Currently active primary layouts, one per local player */
 	UPROPERTY(Transient)
 	TArray<FHUDPrimaryLayoutInstance> ActiveLayouts;
+
+	/** local players waiting for primary layout class to load */
+	TArray<TWeakObjectPtr<ULocalPlayer>> PendingPlayers;
+
+	/** primary layout class load request */
+	TSharedPtr<FStreamableHandle> LayoutClassHandle;
 };
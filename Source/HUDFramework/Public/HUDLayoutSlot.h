@@ -11,18 +11,45 @@ class ULocalPlayer;
 class FHUDLayoutExtension;
 class UHUDLayoutSubsystem;
 
+/** Defines which extensions are accepted by layout slot */
+UENUM(BlueprintType)
+enum class EHUDLayoutSlotMatch: uint8
+{
+	/** Accept extensions registered with the slot tag */
+	ExactMatch,
+	/** Accept extensions registered with the slot tag or any of its child tags */
+	PartialMatch,
+};
+
 class FHUDLayoutSlot: public TSharedFromThis<FHUDLayoutSlot>
 {
 public:
 	FGameplayTag SlotTag;
 	TWeakObjectPtr<const ULocalPlayer> PlayerContext;
+	EHUDLayoutSlotMatch MatchType = EHUDLayoutSlotMatch::ExactMatch;
+	/** assigned by layout tag index, defines notification order. Zero if slot is not registered */
+	uint64 RegistrationId = 0;
 
+	/** add or remove extension. @return extension widget, nullptr if slot has no widget for extension yet */
 	using TSlotCallback = TFunction<UUserWidget*(const FHUDLayoutExtensionRequest&)>;
 	TSlotCallback AddExtension;
 	TSlotCallback RemoveExtension;
 
+	/** optional callback for adding extensions in bulk, output widgets should match requests order */
+	using TSlotBatchCallback = TFunction<void(TConstArrayView<FHUDLayoutExtensionRequest>, TArray<UUserWidget*>&)>;
+	TSlotBatchCallback AddExtensions;
+
+	/** optional callback for handing extension widget over to an equivalent extension. @return false if slot has no widget for the old extension */
+	using TSlotMoveCallback = TFunction<bool(const FHUDLayoutExtensionRequest& /** From */, const FHUDLayoutExtensionRequest& /** To */)>;
+	TSlotMoveCallback MoveExtension;
+
 	FHUDLayoutSlot() = default;
-	FHUDLayoutSlot(const FGameplayTag& InSlotTag, const ULocalPlayer* InLocalPlayer, TSlotCallback&& InAddCallback, TSlotCallback&& InRemoveCallback);
+	FHUDLayoutSlot(const FGameplayTag& InSlotTag, const ULocalPlayer* InLocalPlayer, EHUDLayoutSlotMatch InMatchType, TSlotCallback&& InAddCallback, TSlotCallback&& InRemoveCallback);
+
+	FORCEINLINE bool IsRegistered() const
+	{
+		return RegistrationId != 0;
+	}
 	
 	bool ExtensionPassesRequirements(const TSharedPtr<FHUDLayoutExtension>& Extension) const;
 };
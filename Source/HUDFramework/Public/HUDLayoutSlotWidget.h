@@ -3,13 +3,16 @@
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
 #include "Components/DynamicEntryBoxBase.h"
+#include "Containers/Ticker.h"
 #include "HUDLayoutExtension.h"
+#include "HUDLayoutSlot.h"
 
 #include "HUDLayoutSlotWidget.generated.h"
 
 struct FHUDWidgetContextHandle;
 struct FHUDLayoutSlotHandle;
 struct FHUDLayoutExtensionRequest;
+struct FStreamableHandle;
 
 UCLASS()
 class HUDFRAMEWORK_API UHUDLayoutSlotWidget: public UDynamicEntryBoxBase
@@ -28,6 +31,14 @@ public:
 	
 	UPROPERTY(EditInstanceOnly, BlueprintReadOnly, Category = "Entry Layout", meta = (Validate))
 	FGameplayTag SlotTag;
+
+	/** Whether slot accepts extensions registered with child tags of the slot tag */
+	UPROPERTY(EditInstanceOnly, BlueprintReadOnly, Category = "Entry Layout")
+	EHUDLayoutSlotMatch SlotMatch = EHUDLayoutSlotMatch::ExactMatch;
+	
+	/** Widget displayed in place of extension while extension widget class is loading */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Entry Layout")
+	TSubclassOf<UUserWidget> PlaceholderWidgetClass;
 	
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Entry Layout", meta = (IsBindableEvent = "true"))
 	FConfigureWidget ConfigureWidget;
@@ -41,8 +52,42 @@ protected:
 
 	/** Callback when extension is added to this layout slot */
 	virtual UUserWidget* AddExtension(const FHUDLayoutExtensionRequest& Request);
+	/**
+	 * Callback when multiple extensions are added to this layout slot. All widgets are created before any of them is attached
+	 * Panel still gets one entry child per widget, batching slot-level panel updates is not done here
+	 */
+	virtual void AddExtensions(TConstArrayView<FHUDLayoutExtensionRequest> Requests, TArray<UUserWidget*>& OutWidgets);
 	/** Callback when extension is removed to this layout slot */
 	virtual UUserWidget* RemoveExtension(const FHUDLayoutExtensionRequest& Request);
+	/** Callback when extension is replaced with an equivalent one. Existing extension widget is kept */
+	virtual bool MoveExtension(const FHUDLayoutExtensionRequest& From, const FHUDLayoutExtensionRequest& To);
+
+	/** create extension widget and initialize it with widget context */
+	UUserWidget* CreateExtensionWidget(const FHUDLayoutExtensionRequest& Request);
+	/** add extension widget to the panel, or defer it until panel is constructed */
+	void AttachExtensionWidget(UUserWidget* Widget, const FHUDLayoutExtensionRequest& Request);
+	/** add widget to the panel, or defer it until panel is constructed */
+	void AddEntryWidget(UUserWidget* Widget);
+
+	/** load extension widget class asynchronously, placeholder widget is displayed meanwhile. @return extension widget if class is already loaded */
+	UUserWidget* RequestExtensionClass(const FHUDLayoutExtensionRequest& Request);
+	/** extension widget class is loaded, queue extension widget creation */
+	void HandleExtensionClassLoaded(FHUDLayoutExtensionHandle Handle);
+	/** create extension widgets for loaded classes within per frame budget and report them to layout subsystem */
+	bool ProcessCreationQueue(float DeltaTime);
+	/** cancel pending loads and queued extension widgets */
+	void CancelPendingExtensions();
+
+	struct FPendingExtension
+	{
+		FHUDLayoutExtensionRequest Request;
+		TSharedPtr<FStreamableHandle> StreamableHandle;
+	};
+	/** extensions waiting for their widget class to load or for their turn to be created */
+	TMap<FHUDLayoutExtensionHandle, FPendingExtension> PendingExtensions;
+	/** extensions with loaded widget classes, in load order */
+	TArray<FHUDLayoutExtensionHandle> CreationQueue;
+	FTSTicker::FDelegateHandle CreationTickerHandle;
 
 	UPROPERTY(Transient)
 	TArray<UUserWidget*> PendingWidgets;
@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "HUDLayoutExtension.h"
 #include "HUDLayoutSlot.h"
+#include "HUDLayoutTagIndex.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 
 #include "HUDLayoutSubsystem.generated.h"
@@ -14,8 +15,11 @@ class FHUDLayoutSlot;
 struct FHUDLayoutExtensionHandle;
 struct FHUDLayoutSlotHandle;
 class UHUDLayoutPolicy;
+class UHUDPrimaryLayout;
+struct FStreamableHandle;
 
 DECLARE_MULTICAST_DELEGATE_TwoParams(FSlotExtensionDelegate, UUserWidget* /** ExtensionWidget */, const FHUDLayoutExtension& /** LayoutExtension */);
+DECLARE_MULTICAST_DELEGATE_OneParam(FPrimaryLayoutReadyDelegate, UHUDPrimaryLayout* /** PrimaryLayout */);
 
 UCLASS(Config = Game)
 class HUDFRAMEWORK_API UHUDLayoutSubsystem: public UGameInstanceSubsystem
@@ -23,6 +27,8 @@ class HUDFRAMEWORK_API UHUDLayoutSubsystem: public UGameInstanceSubsystem
 	GENERATED_BODY()
 
 	using TSlotCallback = typename FHUDLayoutSlot::TSlotCallback;
+	using TSlotBatchCallback = typename FHUDLayoutSlot::TSlotBatchCallback;
+	using TSlotMoveCallback = typename FHUDLayoutSlot::TSlotMoveCallback;
 public:
 
 	static UHUDLayoutSubsystem* Get(const UObject* WorldContextObject);
@@ -33,13 +39,37 @@ public:
 
 	UHUDLayoutPolicy* GetPolicy() const { return Policy; }
 
+	/**
+	 * Call @Delegate once primary layout for @LocalPlayer is created. Policy and primary layout classes are loaded asynchronously,
+	 * so primary layout may not be available right after local player is added
+	 * @return delegate handle if delegate was registered, invalid handle if it was called immediately
+	 */
+	FDelegateHandle CallOrRegister_OnPrimaryLayoutReady(const ULocalPlayer* LocalPlayer, FPrimaryLayoutReadyDelegate::FDelegate Delegate);
+	
+	/** Unregister delegate registered with CallOrRegister_OnPrimaryLayoutReady */
+	void Unregister_OnPrimaryLayoutReady(const ULocalPlayer* LocalPlayer, FDelegateHandle Handle);
+
+	/** Called by layout policy when primary layout is created for a local player */
+	void NotifyPrimaryLayoutReady(const ULocalPlayer* LocalPlayer, UHUDPrimaryLayout* PrimaryLayout);
+
+	/** @return true if primary layout is created for @LocalPlayer */
+	bool IsPrimaryLayoutReady(const ULocalPlayer* LocalPlayer) const;
+
+	/** Start loading policy and primary layout classes ahead of time, e.g. from a loading screen */
+	UFUNCTION(BlueprintCallable, Category = "HUD")
+	void PreloadPrimaryLayout();
+
 	/**
 	 * Register layout slot using slot tag
 	 * @SlotTag tag that describes the slot
 	 * @AddCallback callback for adding extensions
 	 * @RemoveCallback callback for removing extensions
+	 * @MatchType whether slot accepts extensions registered with child tags of the slot tag
+	 * @BatchAddCallback optional callback for adding extensions registered in a batch
+	 * @MoveCallback optional callback for reusing extension widgets when layout transaction is committed
 	 */
-	FHUDLayoutSlotHandle RegisterLayoutSlot(const FGameplayTag& SlotTag, const ULocalPlayer* LocalPlayer, TSlotCallback AddCallback, TSlotCallback RemoveCallback);
+	FHUDLayoutSlotHandle RegisterLayoutSlot(const FGameplayTag& SlotTag, const ULocalPlayer* LocalPlayer, TSlotCallback AddCallback, TSlotCallback RemoveCallback,
+		EHUDLayoutSlotMatch MatchType = EHUDLayoutSlotMatch::ExactMatch, TSlotBatchCallback BatchAddCallback = nullptr, TSlotMoveCallback MoveCallback = nullptr);
 	
 	/** Unregister layout slot by handle. Handle is invalidated */
 	void UnregisterLayoutSlot(FHUDLayoutSlotHandle& Handle);
@@ -61,9 +91,82 @@ public:
 	 */
 	FHUDLayoutExtensionHandle RegisterLayoutExtensionWithContext(const FGameplayTag& SlotTag, TSubclassOf<UUserWidget> WidgetClass, const ULocalPlayer* LocalPlayer, const FHUDWidgetContextHandle& Context);
 
+	/**
+	 * Register layout extension with a soft widget class
+	 * If widget class is not loaded, slots load it asynchronously and create extension widget once it is loaded
+	 * @SlotTag slot tag that indicates which slot to extend
+	 * @WidgetClass widget to create
+	 * @Context widget context
+	 */
+	FHUDLayoutExtensionHandle RegisterLayoutExtensionWithSoftClass(const FGameplayTag& SlotTag, const TSoftClassPtr<UUserWidget>& WidgetClass, const ULocalPlayer* LocalPlayer, const FHUDWidgetContextHandle& Context = FHUDWidgetContextHandle{});
+
 	/** Unregister layout extension by handle. Handle is invalidated */
 	void UnregisterLayoutExtension(FHUDLayoutExtensionHandle& Handle);
 
+	/**
+	 * Register multiple layout extensions for a local player
+	 * Extensions are registered first, then each matching slot is notified once with all of its new extensions
+	 * @return extension handles in the same order as @Params
+	 */
+	TArray<FHUDLayoutExtensionHandle> RegisterLayoutExtensions(TConstArrayView<FHUDLayoutExtensionParams> Params, const ULocalPlayer* LocalPlayer);
+
+	/** Unregister layout extensions by handles. Handles are invalidated */
+	void UnregisterLayoutExtensions(TArrayView<FHUDLayoutExtensionHandle> Handles);
+
+	/**
+	 * Begin extension batch. Slots are not notified about extensions registered during the batch until the outermost batch ends
+	 * @see FHUDLayoutExtensionBatchScope
+	 */
+	void BeginExtensionBatch();
+	/** End extension batch, notify slots about extensions registered during the batch */
+	void EndExtensionBatch();
+	
+	FORCEINLINE bool IsExtensionBatchActive() const
+	{
+		return ExtensionBatchDepth > 0;
+	}
+
+	/**
+	 * Begin layout transaction. Works as extension batch that also defers extension removals.
+	 * When outermost transaction is committed, each removed extension is matched with an equivalent added extension,
+	 * and slots hand existing widgets over instead of destroying and creating them again. Only unmatched changes are applied.
+	 * @see FHUDLayoutTransactionScope
+	 */
+	void BeginLayoutTransaction();
+	/** Commit layout transaction, apply the difference between removed and added extensions */
+	void CommitLayoutTransaction();
+
+	FORCEINLINE bool IsLayoutTransactionActive() const
+	{
+		return LayoutTransactionDepth > 0;
+	}
+
+	/**
+	 * Begin layout transaction that is committed at the end of the frame, if it is not already started
+	 * Every layout change until the end of the frame is deferred. Add HUD Layout game feature action begins it when its layouts are removed,
+	 * so layouts and extensions added back by another experience within the same frame reuse existing widgets
+	 * @PrimaryLayout optional primary layout which layer changes are included into the transaction
+	 */
+	void BeginFrameTransaction(UHUDPrimaryLayout* PrimaryLayout = nullptr);
+	/** Commit transaction started with BeginFrameTransaction before the end of the frame. Does nothing if it is not started */
+	void CommitFrameTransaction();
+
+	FORCEINLINE bool IsFrameTransactionActive() const
+	{
+		return FrameTransactionHandle.IsValid();
+	}
+
+	/**
+	 * Consume one asynchronously created extension widget from the per frame budget
+	 * Budget is shared by all slots of this game instance
+	 * @return false if budget for this frame is exhausted
+	 */
+	bool TryConsumeExtensionWidgetBudget();
+
+	/** Called by slots when extension widget is created after its widget class has been loaded asynchronously */
+	void NotifyExtensionWidgetCreated(UUserWidget* Widget, const FHUDLayoutExtensionHandle& Handle);
+
+	/** Broadcast when extension widget is added to a slot. Placeholders of extensions with loading widget classes are not reported */
 	FSlotExtensionDelegate OnExtensionAdded;
 	FSlotExtensionDelegate OnExtensionRemoved;
 
@@ -81,6 +184,10 @@ protected:
 	// Deprecated Functions End
 	
 	// @todo: RegisterLayoutSlot with blueprint delegates?
+
+	/** policy class is loaded, create policy and notify about existing local players */
+	void HandlePolicyClassLoaded();
+	void CreatePolicy(TSubclassOf<UHUDLayoutPolicy> PolicyClass);
 	
 	virtual void OnLocalPlayerAdded(ULocalPlayer* LocalPlayer);
 	virtual void OnLocalPlayerRemoved(ULocalPlayer* LocalPlayer);
@@ -90,22 +197,117 @@ protected:
 
 	void UpdateSlotExtensions(TSharedPtr<FHUDLayoutSlot> Slot, TSlotCallback& CallbackRef, FSlotExtensionDelegate& ExtensionDelegate);
 	
-	void ForEachSlot(FGameplayTag SlotTag, TFunctionRef<void( TSharedPtr<FHUDLayoutSlot> )> Func);
-	void ForEachExtension(FGameplayTag SlotTag, TFunctionRef<void( TSharedPtr<FHUDLayoutExtension> )> Func);
+	/** Call @Func for every slot of extension's local player that may accept @Extension */
+	void ForEachSlot(const FHUDLayoutExtension& Extension, TFunctionRef<void( const TSharedPtr<FHUDLayoutSlot>& )> Func);
+	/** Call @Func for every extension of slot's local player that may be added to @Slot */
+	void ForEachExtension(const FHUDLayoutSlot& Slot, TFunctionRef<void( const TSharedPtr<FHUDLayoutExtension>& )> Func);
 	
+	/** add extension to layout index and notify slots */
+	FHUDLayoutExtensionHandle RegisterLayoutExtensionInternal(TSharedPtr<FHUDLayoutExtension> Extension);
+
 	virtual void NotifyExtensionAdded(TSharedPtr<FHUDLayoutExtension> Extension);
+	/** notify slots about extensions registered during batch, each slot receives all of its extensions at once */
+	virtual void NotifyExtensionsAdded(TConstArrayView<TSharedPtr<FHUDLayoutExtension>> Extensions);
+	/** notify slots that extension @From is replaced with equivalent extension @To */
+	virtual void NotifyExtensionMoved(TSharedPtr<FHUDLayoutExtension> From, TSharedPtr<FHUDLayoutExtension> To);
+
 	virtual void NotifyExtensionRemoved(TSharedPtr<FHUDLayoutExtension> Extension);
 
 	static FHUDLayoutExtensionRequest CreateRequest(const FHUDLayoutExtensionHandle& Handle);
 
 	UPROPERTY(Transient)
 	TObjectPtr<UHUDLayoutPolicy> Policy = nullptr;
+
+	/** policy class load request */
+	TSharedPtr<FStreamableHandle> PolicyClassHandle;
+	/** primary layout preload was requested before policy has been created */
+	bool bPreloadPrimaryLayout = false;
+
+	/** delegates waiting for primary layout, per local player */
+	TMap<TObjectKey<const ULocalPlayer>, FPrimaryLayoutReadyDelegate> PrimaryLayoutReadyDelegates;
+
+	/** @return layout index for local player, created on demand */
+	FHUDLayoutTagIndex& FindOrAddLayoutIndex(const TWeakObjectPtr<const ULocalPlayer>& LocalPlayer);
+	/** @return layout index for local player, nullptr if local player has no slots or extensions */
+	const FHUDLayoutTagIndex* FindLayoutIndex(const TWeakObjectPtr<const ULocalPlayer>& LocalPlayer) const;
+	FHUDLayoutTagIndex* FindLayoutIndex(const TWeakObjectPtr<const ULocalPlayer>& LocalPlayer);
+
+	/** active slots and extensions, partitioned by local player */
+	TMap<TObjectKey<const ULocalPlayer>, FHUDLayoutTagIndex> PlayerLayoutIndices;
+
+	/** release layout index of a removed local player, removal is deferred while layout indices are iterated */
+	void ReleaseLayoutIndex(const ULocalPlayer* LocalPlayer);
+	/** remove layout indices released during iteration */
+	void RemoveReleasedLayoutIndices();
+
+	/** layout indices released while being iterated, removed once iteration ends */
+	TArray<TObjectKey<const ULocalPlayer>> ReleasedLayoutIndices;
+	/** number of active slot or extension iterations over layout indices */
+	int32 LayoutIndexIterationDepth = 0;
+
+	/** extensions registered during current extension batch */
+	TArray<TSharedPtr<FHUDLayoutExtension>> PendingExtensions;
+	int32 ExtensionBatchDepth = 0;
+
+	/** extensions unregistered during current layout transaction, slots are not notified yet */
+	TArray<TSharedPtr<FHUDLayoutExtension>> DeferredRemovals;
+	int32 LayoutTransactionDepth = 0;
+
+	/** frame and number of extension widgets created in it by slots of this game instance */
+	uint64 ExtensionBudgetFrame = 0;
+	int32 NumExtensionWidgetsCreated = 0;
+
+	/** primary layouts which layer transactions are committed with frame transaction */
+	TArray<TWeakObjectPtr<UHUDPrimaryLayout>> FrameTransactionLayouts;
+	FDelegateHandle FrameTransactionHandle;
+};
+
+/** Scoped layout transaction */
+class FHUDLayoutTransactionScope
+{
+public:
+	UE_NONCOPYABLE(FHUDLayoutTransactionScope);
+
+	explicit FHUDLayoutTransactionScope(UHUDLayoutSubsystem* InSubsystem)
+		: Subsystem(InSubsystem)
+	{
+		check(InSubsystem);
+		InSubsystem->BeginLayoutTransaction();
+	}
+
+	~FHUDLayoutTransactionScope()
+	{
+		if (UHUDLayoutSubsystem* LayoutSubsystem = Subsystem.Get())
+		{
+			LayoutSubsystem->CommitLayoutTransaction();
+		}
+	}
+
+private:
+	TWeakObjectPtr<UHUDLayoutSubsystem> Subsystem;
+};
+
+/** Scoped extension batch, slots are notified about extensions registered within the scope once it ends */
+class FHUDLayoutExtensionBatchScope
+{
+public:
+	UE_NONCOPYABLE(FHUDLayoutExtensionBatchScope);
 	
-	using FLayoutSlotArray = TArray<TSharedPtr<FHUDLayoutSlot>>;
-	/** active slots */
-	TMap<FGameplayTag, FLayoutSlotArray> ActiveSlots;
-	
-	using FLayoutExtensionArray = TArray<TSharedPtr<FHUDLayoutExtension>>;
-	/** active extensions */
-	TMap<FGameplayTag, FLayoutExtensionArray> ActiveExtensions;
+	explicit FHUDLayoutExtensionBatchScope(UHUDLayoutSubsystem* InSubsystem)
+		: Subsystem(InSubsystem)
+	{
+		check(InSubsystem);
+		InSubsystem->BeginExtensionBatch();
+	}
+
+	~FHUDLayoutExtensionBatchScope()
+	{
+		if (UHUDLayoutSubsystem* LayoutSubsystem = Subsystem.Get())
+		{
+			LayoutSubsystem->EndExtensionBatch();
+		}
+	}
+
+private:
+	TWeakObjectPtr<UHUDLayoutSubsystem> Subsystem;
 };
@@ -0,0 +1,153 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "HUDLayoutExtension.h"
+#include "HUDLayoutSlot.h"
+#include "Algo/BinarySearch.h"
+
+/**
+ * List of layout slots or extensions sorted by registration id
+ * Safe to iterate while the list is modified: entries removed during iteration are skipped, entries added during iteration are not visited
+ */
+template <typename TEntryType>
+class THUDLayoutRegistrationList
+{
+public:
+	using FEntryPtr = TSharedPtr<TEntryType>;
+
+	void Add(const FEntryPtr& Entry)
+	{
+		// registration ids are monotonic, so appending keeps the list sorted
+		check(Entries.IsEmpty() || Entries.Last()->RegistrationId < Entry->RegistrationId);
+		Entries.Add(Entry);
+		++Generation;
+	}
+
+	bool Remove(const FEntryPtr& Entry)
+	{
+		const int32 Index = Algo::LowerBoundBy(Entries, Entry->RegistrationId, &GetRegistrationId);
+		if (Entries.IsValidIndex(Index) && Entries[Index] == Entry)
+		{
+			Entries.RemoveAt(Index, 1, EAllowShrinking::No);
+			++Generation;
+			return true;
+		}
+		return false;
+	}
+
+	FORCEINLINE bool IsEmpty() const
+	{
+		return Entries.IsEmpty();
+	}
+
+	/** Remove all entries and mark them unregistered */
+	void Reset()
+	{
+		for (const FEntryPtr& Entry: Entries)
+		{
+			Entry->RegistrationId = 0;
+		}
+		Entries.Reset();
+		++Generation;
+	}
+
+	/** Call @Func for every entry registered before @MaxRegistrationId */
+	template <typename TFunc>
+	void ForEach(uint64 MaxRegistrationId, TFunc&& Func) const
+	{
+		uint32 LastGeneration = Generation;
+		for (int32 Index = 0; Index < Entries.Num();)
+		{
+			// entry may be removed by the callback, keep it alive until callback returns
+			const FEntryPtr Entry = Entries[Index];
+			const uint64 RegistrationId = Entry->RegistrationId;
+			if (RegistrationId >= MaxRegistrationId)
+			{
+				break;
+			}
+
+			Func(Entry);
+
+			if (LastGeneration != Generation)
+			{
+				// list has changed, continue from the first entry registered after the visited one
+				LastGeneration = Generation;
+				Index = Algo::UpperBoundBy(Entries, RegistrationId, &GetRegistrationId);
+			}
+			else
+			{
+				++Index;
+			}
+		}
+	}
+
+private:
+
+	static uint64 GetRegistrationId(const FEntryPtr& Entry)
+	{
+		return Entry->RegistrationId;
+	}
+
+	TArray<FEntryPtr> Entries;
+	/** incremented every time list is modified */
+	uint32 Generation = 0;
+};
+
+/**
+ * Layout slots and extensions indexed by slot tag
+ * Tag hierarchy is resolved once per tag, so matching slots and extensions are found without tag manager lookups
+ */
+class HUDFRAMEWORK_API FHUDLayoutTagIndex
+{
+public:
+	using FSlotPtr = TSharedPtr<FHUDLayoutSlot>;
+	using FExtensionPtr = TSharedPtr<FHUDLayoutExtension>;
+
+	FHUDLayoutTagIndex() = default;
+	FHUDLayoutTagIndex(FHUDLayoutTagIndex&&) = default;
+	FHUDLayoutTagIndex& operator=(FHUDLayoutTagIndex&&) = default;
+
+	void AddSlot(const FSlotPtr& Slot);
+	bool RemoveSlot(const FSlotPtr& Slot);
+
+	void AddExtension(const FExtensionPtr& Extension);
+	bool RemoveExtension(const FExtensionPtr& Extension);
+
+	/** Call @Func for every slot that may accept extension with @ExtensionTag: slots with the same tag and partial match slots of parent tags */
+	void ForEachSlot(const FGameplayTag& ExtensionTag, TFunctionRef<void(const FSlotPtr&)> Func) const;
+	
+	/** Call @Func for every extension that may be added to a slot: extensions with the same tag, and extensions with child tags for partial match */
+	void ForEachExtension(const FGameplayTag& SlotTag, EHUDLayoutSlotMatch MatchType, TFunctionRef<void(const FExtensionPtr&)> Func) const;
+
+	void Reset();
+
+	/**
+	 * Unregister all slots and extensions, so their handles are no longer registered
+	 * Tag nodes are kept, so it is safe to call while slots or extensions are iterated
+	 */
+	void ReleaseRegistrations();
+
+private:
+
+	struct FTagNode
+	{
+		/** parent tag nodes, closest parent first */
+		TArray<FTagNode*, TInlineAllocator<4>> Ancestors;
+		/** slots registered with this tag */
+		THUDLayoutRegistrationList<FHUDLayoutSlot> Slots;
+		/** partial match slots registered with this tag */
+		THUDLayoutRegistrationList<FHUDLayoutSlot> PartialSlots;
+		/** extensions registered with this tag */
+		THUDLayoutRegistrationList<FHUDLayoutExtension> Extensions;
+		/** extensions registered with this tag or any of its child tags */
+		THUDLayoutRegistrationList<FHUDLayoutExtension> SubtreeExtensions;
+	};
+
+	FTagNode& FindOrAddNode(const FGameplayTag& Tag);
+	const FTagNode* FindNode(const FGameplayTag& Tag) const;
+
+	/** tag nodes are never removed, ancestor pointers stay valid until index is reset */
+	TMap<FGameplayTag, TUniquePtr<FTagNode>> Nodes;
+	uint64 NextRegistrationId = 1;
+};
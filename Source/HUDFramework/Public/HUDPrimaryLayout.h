@@ -93,57 +93,38 @@ public:
 	template <typename TActivatableWidget>
 	TActivatableWidget* PushWidgetToLayer(FGameplayTag LayerTag, TSubclassOf<TActivatableWidget> WidgetClass)
 	{
-		checkf(bAddWidgetGuard == false, TEXT("trying to add another activatable widget in the same callstack."));
-		if (UCommonActivatableWidgetContainerBase* Layer = GetLayerWidget(LayerTag))
-		{
-			TGuardValue Guard{bAddWidgetGuard, true};
-			return Layer->AddWidget<TActivatableWidget>(WidgetClass);
-		}
-
-		UE_LOG(LogHUDFramework, Error, TEXT("Failed to push widget %s to layer %s, layer is not registered."), *WidgetClass->GetName(), *LayerTag.ToString());
-		return nullptr;
+		return PushWidgetToLayerInternal<TActivatableWidget>(LayerTag, WidgetClass, FHUDWidgetContextHandle{}, nullptr);
 	}
 
-	/** Adds activatable widget of @WidgetClass to the layer referenced by @LayerTag. Overload that calls @InitFunc after creating a widget */
+	/**
+	 * Adds activatable widget of @WidgetClass to the layer referenced by @LayerTag. Overload that calls @InitFunc after creating a widget
+	 * @InitFunc is also called for a widget reused during layer transaction
+	 */
 	template <typename TActivatableWidget>
 	TActivatableWidget* PushWidgetToLayer(FGameplayTag LayerTag, TSubclassOf<TActivatableWidget> WidgetClass, TFunction<void(TActivatableWidget&)> InitFunc)
 	{
-		checkf(bAddWidgetGuard == false, TEXT("trying to add another activatable widget in the same callstack."));
-		if (UCommonActivatableWidgetContainerBase* Layer = GetLayerWidget(LayerTag))
-		{
-			TGuardValue Guard{bAddWidgetGuard, true};
-			return Layer->AddWidget<TActivatableWidget>(WidgetClass, InitFunc);
-		}
-
-		UE_LOG(LogHUDFramework, Error, TEXT("Failed to push widget %s to layer %s, layer is not registered."), *WidgetClass->GetName(), *LayerTag.ToString());
-		return nullptr;
+		return PushWidgetToLayerInternal<TActivatableWidget>(LayerTag, WidgetClass, FHUDWidgetContextHandle{}, InitFunc);
 	}
 
 	template <typename TActivatableWidget>
 	TActivatableWidget* PushWidgetToLayer(FGameplayTag LayerTag, TSubclassOf<TActivatableWidget> WidgetClass, const FHUDWidgetContextHandle& WidgetContext)
 	{
-		checkf(bAddWidgetGuard == false, TEXT("trying to add another activatable widget in the same callstack."));
-		if (UCommonActivatableWidgetContainerBase* Layer = GetLayerWidget(LayerTag))
-		{
-			TGuardValue Guard{bAddWidgetGuard, true};
-			ActiveContext = WidgetContext;
-			
-			TActivatableWidget* Widget = Layer->AddWidget<TActivatableWidget>(WidgetClass);
-			// activatable widget should 'consume' widget context
-			check(!ActiveContext.IsValid());
-
-			return Widget;
-		}
-
-		UE_LOG(LogHUDFramework, Error, TEXT("Failed to push widget %s to layer %s, layer is not registered."), *WidgetClass->GetName(), *LayerTag.ToString());
-		return nullptr;
+		return PushWidgetToLayerInternal<TActivatableWidget>(LayerTag, WidgetClass, WidgetContext, nullptr);
 	}
 
 	/** finds if widget exists on any layers and removes it from residing layer */
 	void PopWidget(UCommonActivatableWidget* Widget);
 
-	/** Removes widget from residing layer */
+	/** Removes widget from residing layer. Removal is deferred during layer transaction */
 	void PopWidgetFromLayer(FGameplayTag LayerTag, UCommonActivatableWidget* Widget);
+
+	/**
+	 * Begin layer transaction. Widgets popped from layers are kept until transaction is committed,
+	 * and widget of the same class and widget context pushed to the same layer reuses popped widget instead of creating a new one
+	 */
+	void BeginLayerTransaction();
+	/** Commit layer transaction, pop widgets that were not reused */
+	void CommitLayerTransaction();
 	
 	/** @return layer widget for given @LayerTag */
 	UFUNCTION(BlueprintPure, Category = "Layer")
@@ -157,7 +138,64 @@ public:
 	void UnregisterLayer(UPARAM(meta = (Categories = "HUD.Layer")) FGameplayTag LayerTag);
 
 	void InitActivatableWidget(UCommonActivatableWidget& NewWidget);
+
+	/**
+	 * Update player context for primary layout and every widget pushed to its layers
+	 * Used when primary layout is kept alive across player controller change
+	 */
+	void UpdatePlayerContext(const FLocalPlayerContext& InPlayerContext);
 protected:
+
+	/** Push widget to layer. Widget popped from the same layer during layer transaction is reused if it has the same class and widget context */
+	template <typename TActivatableWidget>
+	TActivatableWidget* PushWidgetToLayerInternal(FGameplayTag LayerTag, TSubclassOf<TActivatableWidget> WidgetClass, const FHUDWidgetContextHandle& WidgetContext, const TFunction<void(TActivatableWidget&)>& InitFunc)
+	{
+		checkf(bAddWidgetGuard == false, TEXT("trying to add another activatable widget in the same callstack."));
+		if (UCommonActivatableWidget* DeferredWidget = ReuseDeferredWidget(LayerTag, WidgetClass, WidgetContext))
+		{
+			TActivatableWidget* Widget = CastChecked<TActivatableWidget>(DeferredWidget);
+			if (InitFunc)
+			{
+				InitFunc(*Widget);
+			}
+			return Widget;
+		}
+		
+		if (UCommonActivatableWidgetContainerBase* Layer = GetLayerWidget(LayerTag))
+		{
+			TGuardValue Guard{bAddWidgetGuard, true};
+			ActiveContext = WidgetContext;
+
+			TActivatableWidget* Widget = InitFunc ? Layer->AddWidget<TActivatableWidget>(WidgetClass, InitFunc) : Layer->AddWidget<TActivatableWidget>(WidgetClass);
+			// activatable widget should 'consume' widget context
+			check(!ActiveContext.IsValid());
+
+			if (Widget != nullptr && WidgetContext.IsValid())
+			{
+				LayerWidgetContexts.Add(Widget, WidgetContext);
+			}
+			return Widget;
+		}
+
+		UE_LOG(LogHUDFramework, Error, TEXT("Failed to push widget %s to layer %s, layer is not registered."), *WidgetClass->GetName(), *LayerTag.ToString());
+		return nullptr;
+	}
+
+	/** @return widget of @WidgetClass with @WidgetContext popped from @LayerTag during current layer transaction */
+	UCommonActivatableWidget* ReuseDeferredWidget(FGameplayTag LayerTag, UClass* WidgetClass, const FHUDWidgetContextHandle& WidgetContext);
+
+	struct FDeferredPop
+	{
+		FGameplayTag LayerTag;
+		TWeakObjectPtr<UCommonActivatableWidget> Widget;
+		FHUDWidgetContextHandle WidgetContext;
+	};
+	/** widgets popped during current layer transaction */
+	TArray<FDeferredPop> DeferredPops;
+	int32 LayerTransactionDepth = 0;
+
+	/** widget contexts of widgets pushed to layers with a context, used to match popped widgets during layer transaction */
+	TMap<TObjectKey<UCommonActivatableWidget>, FHUDWidgetContextHandle> LayerWidgetContexts;
 	
 	/** Context for a widget currently being added to the layer */
 	FHUDWidgetContextHandle ActiveContext;
@@ -1,12 +1,14 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "HUDFramework.h"
 
 #include "HUDWidgetContext.generated.h"
 
 struct FHUDWidgetContextBase;
 struct FHUDWidgetContext;
 struct FHUDWidgetContextHandle;
+class UPackageMap;
 using FHUDWidgetContextProxy = FHUDWidgetContextBase;
 
 /**
@@ -72,6 +74,7 @@ struct HUDFRAMEWORK_API FHUDWidgetContextHandle
 	template <typename TContextType, typename ...TArgs>
 	static FHUDWidgetContextHandle CreateContext(TArgs&&... Args)
 	{
+		LLM_SCOPE_BYTAG(HUDFramework_WidgetContexts);
 		return FHUDWidgetContextHandle{MakeShared<TContextType>(Forward<TArgs>(Args)...)};
 	}
 
@@ -159,9 +162,29 @@ struct HUDFRAMEWORK_API FHUDWidgetContextHandle
 		return !(*this == Other);
 	}
 
+	/**
+	 * Value comparison, handles are identical if they hold contexts of the same type with identical data
+	 * Used by property comparison, so replication resends context only when its data actually changes
+	 */
+	bool Identical(const FHUDWidgetContextHandle* Other, uint32 PortFlags) const;
+
+	/**
+	 * Serialize context type as an object reference followed by the context data
+	 * Type reference is stable between builds, use it for saving
+	 */
+	bool Serialize(FArchive& Ar);
+
+	/**
+	 * Net serialize context type as a type id followed by replicated context data
+	 * Type id is a hash of the context type path name, so it is the same on server and client regardless of loaded modules
+	 */
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
 private:
+
+	/** net serialize context data for the currently held context type */
+	bool NetSerializeContextData(FArchive& Ar, UPackageMap* Map);
 	
-	// @todo: custom serialization
 	TSharedPtr<FHUDWidgetContextProxy> ContextData;
 	TWeakObjectPtr<const UScriptStruct> ContextType;
 };
@@ -172,8 +195,89 @@ struct TStructOpsTypeTraits<FHUDWidgetContextHandle>: public TStructOpsTypeTrait
 	enum
 	{
 		WithCopy = true, // Necessary so that TSharedPtr data is copied around
-		WithIdenticalViaEquality = true,
+		WithIdentical = true,
+		WithSerializer = true,
+		WithNetSerializer = true,
+	};
+};
+
+/**
+ * Slab allocator for widget contexts of the same type
+ * Contexts are constructed in place inside fixed size chunks, and each handle aliases reference counter of the chunk it was allocated from.
+ * Reference counting rules are the same as for @FHUDWidgetContextHandle::CreateContext, chunk memory is released when the last handle
+ * referencing any of its contexts goes away.
+ * Use it for bursts of widget contexts (e.g. indicators) to replace an allocation per context with an allocation per chunk.
+ * @note not thread safe, expected to be used from the game thread only
+ */
+template <typename TContextType, int32 ChunkSize = 64>
+class THUDWidgetContextArena
+{
+	static_assert(TIsDerivedFrom<TContextType, FHUDWidgetContextProxy>::IsDerived, "Arena context type should be derived from FHUDWidgetContextBase");
+	static_assert(ChunkSize > 0, "Arena chunk size should be positive");
+public:
+
+	THUDWidgetContextArena() = default;
+	THUDWidgetContextArena(const THUDWidgetContextArena&) = delete;
+	THUDWidgetContextArena& operator=(const THUDWidgetContextArena&) = delete;
+
+	/** @return handle to the context constructed in place from @Args */
+	template <typename ...TArgs>
+	FHUDWidgetContextHandle CreateContext(TArgs&&... Args)
+	{
+		if (!CurrentChunk.IsValid() || CurrentChunk->IsFull())
+		{
+			LLM_SCOPE_BYTAG(HUDFramework_WidgetContexts);
+			CurrentChunk = MakeShared<FChunk>();
+		}
+
+		TContextType* Context = CurrentChunk->Emplace(Forward<TArgs>(Args)...);
+		// aliasing constructor, handle shares reference counter with the chunk
+		return FHUDWidgetContextHandle{TSharedRef<TContextType>{CurrentChunk.ToSharedRef(), Context}};
+	}
+
+	/** Stop allocating from the current chunk. Already created contexts stay valid until their handles are released */
+	void Reset()
+	{
+		CurrentChunk.Reset();
+	}
+
+private:
+
+	struct FChunk
+	{
+		FChunk() = default;
+		FChunk(const FChunk&) = delete;
+		FChunk& operator=(const FChunk&) = delete;
+
+		~FChunk()
+		{
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				DestructItem(Storage[Index].GetTypedPtr());
+			}
+		}
+
+		FORCEINLINE bool IsFull() const
+		{
+			return Num == ChunkSize;
+		}
+
+		template <typename ...TArgs>
+		TContextType* Emplace(TArgs&&... Args)
+		{
+			check(!IsFull());
+			TContextType* Context = new (Storage[Num].GetTypedPtr()) TContextType(Forward<TArgs>(Args)...);
+			++Num;
+
+			return Context;
+		}
+
+		TTypeCompatibleBytes<TContextType> Storage[ChunkSize];
+		int32 Num = 0;
 	};
+
+	/** chunk new contexts are allocated from */
+	TSharedPtr<FChunk> CurrentChunk;
 };
 
 /**
@@ -119,34 +119,9 @@ private:
 			return nullptr;
 		}
 
-		UUserWidget* WidgetInstance = nullptr;
-		for (UUserWidget* InactiveWidget : InactiveWidgets)
-		{
-			if (InactiveWidget->GetClass() == WidgetClass)
-			{
-				WidgetInstance = InactiveWidget;
-				InactiveWidgets.RemoveSingleSwap(InactiveWidget);
-				break;
-			}
-		}
+		UUserWidget* WidgetInstance = AcquireWidgetInstance(WidgetClass);
 
 		UWidget* OwningWidgetPtr = OwningWidget.Get();
-		if (!WidgetInstance)
-		{
-			if (OwningWidgetPtr)
-			{
-				WidgetInstance = CreateWidget(OwningWidgetPtr, WidgetClass);
-			}
-			else if (APlayerController* PlayerControllerPtr = DefaultPlayerController.Get())
-			{
-				WidgetInstance = CreateWidget(PlayerControllerPtr, WidgetClass);
-			}
-			else
-			{
-				WidgetInstance = CreateWidget(OwningWorld.Get(), WidgetClass);
-			}
-		}
-
 		if (WidgetInstance)
 		{
 			ActiveWidgets.Add(WidgetInstance);
@@ -155,17 +130,18 @@ private:
 			// For pools owned by a widget, we never want to construct Slate widgets before the owning widget itself has built any Slate
 			if (!OwningWidgetPtr || OwningWidgetPtr->GetCachedWidget().IsValid())
 			{
-				TSharedPtr<SWidget>& CachedSlateWidget = CachedSlateByWidgetObject.FindOrAdd(WidgetInstance);
-				if (!CachedSlateWidget.IsValid())
-				{
-					CachedSlateWidget = WidgetInstance->TakeDerivedWidget(ConstructWidgetFunc);
-				}
+				TakeSlateWidget(WidgetInstance, ConstructWidgetFunc);
 			}
 		}
 
 		return Cast<UserWidgetT>(WidgetInstance);
 	}
 
+	/** @return inactive widget of @WidgetClass, or a new widget if pool has none */
+	UUserWidget* AcquireWidgetInstance(TSubclassOf<UUserWidget> WidgetClass);
+	/** construct and cache slate widget for active @WidgetInstance */
+	void TakeSlateWidget(UUserWidget* WidgetInstance, WidgetConstructFunc ConstructWidgetFunc);
+
 	UPROPERTY(Transient)
 	TArray<TObjectPtr<UUserWidget>> ActiveWidgets;
 	
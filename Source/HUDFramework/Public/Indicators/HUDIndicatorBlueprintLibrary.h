@@ -1,8 +1,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "HUDWidgetContext.h"
 #include "HUDIndicatorDescriptor.h"
+#include "HUDIndicatorTypes.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 
 #include "HUDIndicatorBlueprintLibrary.generated.h"
@@ -11,24 +11,6 @@ class AActor;
 class USceneComponent;
 class UHUDIndicatorDescriptor;
 
-USTRUCT(BlueprintType)
-struct FIndicatorWidgetContext: public FHUDWidgetContextBase
-{
-	GENERATED_BODY()
-
-	FIndicatorWidgetContext() = default;
-	FIndicatorWidgetContext(UObject* InContextObject, const UHUDIndicatorDescriptor* InDescriptor)
-		: ContextObject(InContextObject)
-		, Descriptor(InDescriptor)
-	{}
-	
-	UPROPERTY(BlueprintReadWrite)
-	UObject* ContextObject = nullptr;
-
-	UPROPERTY(BlueprintReadWrite)
-	const UHUDIndicatorDescriptor* Descriptor = nullptr;
-};
-
 UCLASS()
 class HUDFRAMEWORK_API UHUDIndicatorBlueprintLibrary: public UBlueprintFunctionLibrary
 {
@@ -47,11 +29,32 @@ protected:
 	UFUNCTION(BlueprintCallable, DisplayName = "Add Indicator With Context (Component)")
 	static void AddIndicator_ComponentWithContext(const UHUDIndicatorDescriptor* Descriptor, const USceneComponent* Component, FName SocketName = NAME_None, UObject* ContextObject = nullptr);
 
+	UFUNCTION(BlueprintCallable, DisplayName = "Add Indicators (Actors)")
+	static void AddIndicators_Actors(const UHUDIndicatorDescriptor* Descriptor, const TArray<AActor*>& OwnerActors);
+
+	UFUNCTION(BlueprintCallable, DisplayName = "Add Indicators (Components)")
+	static void AddIndicators_Components(const UHUDIndicatorDescriptor* Descriptor, const TArray<USceneComponent*>& Components, FName SocketName = NAME_None);
+
 	UFUNCTION(BlueprintCallable, DisplayName = "Remove Indicator By Actor")
 	static void RemoveIndicator_Actor(const AActor* OwnerActor);
 
 	UFUNCTION(BlueprintCallable, DisplayName = "Remove Indicator By Component")
 	static void RemoveIndicator_Component(const USceneComponent* Component);
+
+	UFUNCTION(BlueprintCallable, DisplayName = "Remove Indicators By Actors")
+	static void RemoveIndicators_Actors(const TArray<AActor*>& OwnerActors);
+
+	UFUNCTION(BlueprintCallable, DisplayName = "Remove Indicators By Components")
+	static void RemoveIndicators_Components(const TArray<USceneComponent*>& Components);
+
+	UFUNCTION(BlueprintCallable, DisplayName = "Add Indicator (Location)", meta = (WorldContext = "WorldContextObject"))
+	static FHUDIndicatorHandle AddIndicator_Location(const UObject* WorldContextObject, const UHUDIndicatorDescriptor* Descriptor, FVector WorldLocation, UObject* ContextObject = nullptr);
+
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject"))
+	static void SetIndicatorLocation(const UObject* WorldContextObject, FHUDIndicatorHandle Handle, FVector WorldLocation);
+
+	UFUNCTION(BlueprintCallable, DisplayName = "Remove Indicator By Handle", meta = (WorldContext = "WorldContextObject"))
+	static void RemoveIndicator_Handle(const UObject* WorldContextObject, FHUDIndicatorHandle Handle);
 };
 
 
@@ -7,6 +7,68 @@
 
 class SIndicatorCanvas;
 
+/** Shape of the screen area clamped indicators are kept in */
+UENUM(BlueprintType)
+enum class EHUDIndicatorClampShape: uint8
+{
+	Rectangle,
+	/** Rectangle with rounded corners, see ClampCornerRadius */
+	RoundedRectangle,
+	/** Ellipse inscribed into the clamp rectangle */
+	Ellipse,
+};
+
+/**
+ * Indicator canvas settings
+ * Canvas tracks every indicator of its categories, but creates indicator widgets only for indicators that pass visibility checks
+ */
+USTRUCT(BlueprintType)
+struct HUDFRAMEWORK_API FHUDIndicatorCanvasSettings
+{
+	GENERATED_BODY()
+
+	/** Time in seconds indicator keeps its widget after it became invisible */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Materialization", meta = (ClampMin = 0, Units = "s"))
+	float DematerializeGracePeriod = 2.f;
+
+	/** Maximum number of indicator widgets requested per frame, 0 means no limit */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Materialization", meta = (ClampMin = 0))
+	int32 MaxMaterializationsPerFrame = 8;
+
+	/** Maximum number of indicator widgets alive at the same time, 0 means no limit */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Materialization", meta = (ClampMin = 0))
+	int32 MaxMaterializedIndicators = 0;
+
+	/** Indicators that don't clamp to screen are visible if they are off the screen by less than this margin */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Materialization", meta = (ClampMin = 0))
+	float OffscreenMargin = 100.f;
+
+	/** Shape of the screen area clamped indicators are kept in */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Clamp")
+	EHUDIndicatorClampShape ClampShape = EHUDIndicatorClampShape::Rectangle;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Clamp", meta = (EditCondition = "ClampShape == EHUDIndicatorClampShape::RoundedRectangle", ClampMin = 0))
+	float ClampCornerRadius = 150.f;
+
+	/**
+	 * Maximum number of occlusion traces issued per frame, 0 means no limit
+	 * Indicators are traced in rotation, near and high priority indicators are traced more often
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Occlusion", meta = (ClampMin = 0))
+	int32 MaxOcclusionTracesPerFrame = 16;
+
+	/** Depth at which indicator is traced half as often as an indicator right at the view */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Occlusion", meta = (ClampMin = 1, Units = "cm"))
+	float OcclusionFalloffDistance = 2000.f;
+
+	/**
+	 * Paint indicators of the same descriptor together on their own layers, so Slate can batch their draw elements
+	 * Priority order between indicators is kept, depth order is kept only between indicators of the same descriptor
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Paint")
+	bool bGroupPaintLayers = false;
+};
+
 UCLASS()
 class HUDFRAMEWORK_API UHUDIndicatorCanvasWidget : public UWidget
 {
@@ -31,6 +93,9 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Canvas")
 	FSlateBrush ArrowBrush;
 
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Canvas")
+	FHUDIndicatorCanvasSettings CanvasSettings;
+
 protected:
 	UPROPERTY(Transient)
 	FHUDWidgetPool WidgetPool;
@@ -1,10 +1,79 @@
 ﻿#pragma once
 
 #include "GameplayTagContainer.h"
+#include "Engine/EngineTypes.h"
+#include "Styling/SlateBrush.h"
 #include "HUDIndicatorDescriptor.generated.h"
 
 class UHUDIndicatorProjectionMode;
 
+/** Defines how indicator reacts to its target being occluded from the view */
+UENUM(BlueprintType)
+enum class EHUDIndicatorOcclusionMode: uint8
+{
+	/** Indicator is not tested for occlusion */
+	None,
+	/** Occluded indicator is hidden */
+	Hide,
+	/** Occluded indicator is drawn with OccludedOpacity */
+	Dim,
+	/** Occluded indicator is not clamped to screen */
+	SkipClamp,
+};
+
+enum class EHUDIndicatorDescriptorFlags: uint8
+{
+	None						= 0,
+	EnableScaling				= 1 << 0,
+	ClampToScreen				= 1 << 1,
+	ShowClampToScreenArrow		= 1 << 2,
+	OverrideArrowBrush			= 1 << 3,
+	DisplayWhenCannotRender		= 1 << 4,
+};
+ENUM_CLASS_FLAGS(EHUDIndicatorDescriptorFlags);
+
+/**
+ * Descriptor data in the form used by the indicator canvas every frame
+ * Built from descriptor properties on load, so the canvas doesn't evaluate scale curve and alignment per indicator
+ */
+struct FHUDIndicatorDescriptorRuntimeData
+{
+	static constexpr int32 ScaleLUTSize = 64;
+
+	/** @return indicator scale at @Depth, linearly interpolated between baked scale curve samples */
+	FORCEINLINE float GetScale(double Depth) const
+	{
+		if (!EnumHasAnyFlags(Flags, EHUDIndicatorDescriptorFlags::EnableScaling))
+		{
+			return 1.f;
+		}
+		
+		const float Sample = FMath::Clamp(static_cast<float>((Depth - MinDepth) * InvDepthStep), 0.f, static_cast<float>(ScaleLUTSize - 1));
+		const int32 Index = FMath::Min(FMath::FloorToInt32(Sample), ScaleLUTSize - 2);
+		return FMath::Lerp(ScaleLUT[Index], ScaleLUT[Index + 1], Sample - Index);
+	}
+
+	FORCEINLINE bool HasAnyFlags(EHUDIndicatorDescriptorFlags InFlags) const
+	{
+		return EnumHasAnyFlags(Flags, InFlags);
+	}
+
+	/** scale curve sampled at fixed depth steps, starting at MinDepth */
+	float ScaleLUT[ScaleLUTSize] = {};
+	float MinDepth = 0.f;
+	float InvDepthStep = 0.f;
+	/**
+	 * Fraction of indicator size that lies before its screen position, per axis
+	 * 0 for left/top, 0.5 for center/fill, 1 for right/bottom alignment
+	 */
+	FVector2f Alignment = FVector2f{0.5f};
+	float MaxDistance = 0.f;
+	float OccludedOpacity = 1.f;
+	int32 Priority = 0;
+	EHUDIndicatorOcclusionMode OcclusionMode = EHUDIndicatorOcclusionMode::None;
+	EHUDIndicatorDescriptorFlags Flags = EHUDIndicatorDescriptorFlags::None;
+};
+
 /*
  * Data asset that describes common behavior for all indicators of certain type
  */
@@ -14,6 +83,32 @@ class HUDFRAMEWORK_API UHUDIndicatorDescriptor : public UDataAsset
 	GENERATED_BODY()
 	
 public:
+
+	// ~Begin UObject Interface
+	virtual void PostInitProperties() override;
+	virtual void PostLoad() override;
+	virtual void BeginDestroy() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	// ~End UObject Interface
+
+	FORCEINLINE const FHUDIndicatorDescriptorRuntimeData& GetRuntimeData() const
+	{
+		return RuntimeData;
+	}
+
+	/** Rebuild runtime data from descriptor properties. Call it after changing descriptor properties or its scale curve at runtime */
+	void BuildRuntimeData();
+
+#if WITH_EDITOR
+protected:
+	/** rebuild scale LUT when scale curve is edited, curve asset changes don't reach descriptor otherwise */
+	void HandleObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+	FDelegateHandle ObjectPropertyChangedHandle;
+public:
+#endif
+	
 	/* Defines which indicator canvas widget should manage group of indicators with this descriptor */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "indicator", meta = (Validate))
 	FGameplayTag CategoryTag;
@@ -29,6 +124,20 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Indicator", meta = (ClampMin = 0))
 	int32 Priority = 0;
 
+	/* Indicator is hidden and its widget is not created further than this distance from the view. 0 means no limit */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Indicator", meta = (ClampMin = 0, Units = "cm"))
+	float MaxDistance = 0.f;
+
+	/* Defines how indicator reacts to its target being occluded. Occlusion is tested with async line traces from the view to the indicator */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Indicator|Occlusion")
+	EHUDIndicatorOcclusionMode OcclusionMode = EHUDIndicatorOcclusionMode::None;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Indicator|Occlusion", meta = (EditCondition = "OcclusionMode != EHUDIndicatorOcclusionMode::None"))
+	TEnumAsByte<ECollisionChannel> OcclusionTraceChannel = ECC_Visibility;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Indicator|Occlusion", meta = (EditCondition = "OcclusionMode == EHUDIndicatorOcclusionMode::Dim", ClampMin = 0, ClampMax = 1))
+	float OccludedOpacity = 0.35f;
+
 	/* Should indicator display even if Component can not render? */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Indicator", AdvancedDisplay)
 	bool bDisplayIndicatorWhenComponentCanNotRender = false;
@@ -49,9 +158,19 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Indicator|Clamp", meta = (EditCondition = "bClampToScreen == true"))
 	bool bShowClampToScreenArrow = false;
 
+	/* Should clamped indicator use its own arrow brush instead of the indicator canvas arrow brush? */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Indicator|Clamp", meta = (InlineEditConditionToggle))
+	bool bOverrideArrowBrush = false;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Indicator|Clamp", meta = (EditCondition = "bOverrideArrowBrush"))
+	FSlateBrush ArrowBrush;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Indicator|Alignment")
 	TEnumAsByte<EHorizontalAlignment> HorizontalAlignment = HAlign_Center;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Indicator|Alignment")
 	TEnumAsByte<EVerticalAlignment> VerticalAlignment = VAlign_Center;
+
+protected:
+	FHUDIndicatorDescriptorRuntimeData RuntimeData;
 };
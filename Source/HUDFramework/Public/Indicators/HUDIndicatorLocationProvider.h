@@ -0,0 +1,17 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Source of world location for indicators that don't target a scene component, e.g. map pings or grenade warnings
+ * Plain C++ interface, so providers can be created in bulk without spawning actors or allocating UObjects
+ * @note queried from the game thread once per frame for every canvas the indicator is tracked by
+ */
+class HUDFRAMEWORK_API IHUDIndicatorLocationProvider
+{
+public:
+	virtual ~IHUDIndicatorLocationProvider() = default;
+
+	/** @return current world location of the indicator */
+	virtual FVector GetIndicatorLocation() const = 0;
+};
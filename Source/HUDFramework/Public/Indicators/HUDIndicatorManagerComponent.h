@@ -1,7 +1,13 @@
 ﻿#pragma once
 
+#include "GameplayTagContainer.h"
 #include "HUDWidgetContext.h"
+#include "HUDIndicatorTypes.h"
+#include "HUDIndicatorLocationProvider.h"
 #include "Components/GameStateComponent.h"
+#include "Engine/NetSerialization.h"
+#include "Engine/TimerHandle.h"
+#include "Net/Serialization/FastArraySerializer.h"
 #include "HUDIndicatorManagerComponent.generated.h"
 
 struct FHUDWidgetContextHandle;
@@ -20,6 +26,25 @@ struct HUDFRAMEWORK_API FIndicatorDescriptorInstance
 		, WidgetContext(InWidgetContext)
 	{}
 
+	/** @return whether indicator targets a world location or a location provider instead of a scene component */
+	FORCEINLINE bool IsPositional() const
+	{
+		return Handle.IsValid();
+	}
+
+	/** @return whether indicator target is still alive. Positional indicators are alive until removed */
+	FORCEINLINE bool HasValidTarget() const
+	{
+		return IsPositional() || ::IsValid(Component);
+	}
+
+	/** @return world location of a positional indicator */
+	FORCEINLINE FVector GetWorldLocation() const
+	{
+		check(IsPositional());
+		return LocationProvider.IsValid() ? LocationProvider->GetIndicatorLocation() : WorldLocation;
+	}
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	TObjectPtr<const UHUDIndicatorDescriptor> Descriptor;
 	
@@ -31,9 +56,106 @@ struct HUDFRAMEWORK_API FIndicatorDescriptorInstance
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FHUDWidgetContextHandle WidgetContext;
+
+	/** Location of positional indicator, used if it doesn't have a location provider */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector WorldLocation = FVector::ZeroVector;
+
+	/** Location source of positional indicator */
+	TSharedPtr<IHUDIndicatorLocationProvider> LocationProvider;
+
+	/** valid only for positional indicators */
+	FHUDIndicatorHandle Handle;
+
+	/** keys indicator is indexed by in indicator manager, valid even after owner or component are destroyed */
+	TObjectKey<const AActor> OwnerKey;
+	TObjectKey<const USceneComponent> ComponentKey;
+	FGameplayTag CategoryTag;
+};
+
+/** Indicators are added and removed in bursts, delegates are broadcast once per burst */
+DECLARE_MULTICAST_DELEGATE_OneParam(FIndicatorListDelegate, TConstArrayView<TSharedRef<FIndicatorDescriptorInstance>>);
+
+class UHUDIndicatorManagerComponent;
+
+/** Replicated indicator, targets either a scene component or a world location */
+USTRUCT()
+struct HUDFRAMEWORK_API FHUDReplicatedIndicator: public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	/** descriptor asset, replicated as a net guid */
+	UPROPERTY()
+	TObjectPtr<const UHUDIndicatorDescriptor> Descriptor;
+
+	/** target component, may stay unmapped on client until its actor is replicated */
+	UPROPERTY()
+	TObjectPtr<const USceneComponent> Component;
+
+	UPROPERTY()
+	FName SocketName = NAME_None;
+
+	/** target location of positional indicator */
+	UPROPERTY()
+	FVector_NetQuantize WorldLocation = FVector::ZeroVector;
+
+	UPROPERTY()
+	FHUDWidgetContextHandle WidgetContext;
+
+	UPROPERTY()
+	bool bPositional = false;
+
+	/** server allocated handle, shared by local indicator of this entry on every machine */
+	UPROPERTY()
+	FHUDIndicatorHandle Handle;
+
+	/** local indicator created for this entry, never exists on dedicated server */
+	TSharedPtr<FIndicatorDescriptorInstance> Instance;
+};
+
+/**
+ * Replicated indicator list, clients receive only changed entries
+ * Indicators added and removed during a single replication update are broadcast to canvases in one batch
+ */
+USTRUCT()
+struct HUDFRAMEWORK_API FHUDReplicatedIndicatorList: public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	// ~Begin FFastArraySerializer contract
+	void PreReplicatedRemove(const TArrayView<int32> RemovedIndices, int32 FinalSize);
+	void PostReplicatedAdd(const TArrayView<int32> AddedIndices, int32 FinalSize);
+	void PostReplicatedChange(const TArrayView<int32> ChangedIndices, int32 FinalSize);
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+	// ~End FFastArraySerializer contract
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParams)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FHUDReplicatedIndicator, FHUDReplicatedIndicatorList>(Items, DeltaParams, *this);
+	}
+
+private:
+	
+	UPROPERTY()
+	TArray<FHUDReplicatedIndicator> Items;
+
+	UHUDIndicatorManagerComponent* Owner = nullptr;
+
+	/** local indicators added and removed during current replication update */
+	TArray<TSharedRef<FIndicatorDescriptorInstance>> PendingAdded;
+	TArray<TSharedRef<FIndicatorDescriptorInstance>> PendingRemoved;
+
+	friend class UHUDIndicatorManagerComponent;
 };
 
-DECLARE_MULTICAST_DELEGATE_OneParam(FIndicatorDelegate, const TSharedRef<FIndicatorDescriptorInstance>&);
+template<>
+struct TStructOpsTypeTraits<FHUDReplicatedIndicatorList>: public TStructOpsTypeTraitsBase2<FHUDReplicatedIndicatorList>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
 
 UCLASS(BlueprintType)
 class HUDFRAMEWORK_API UHUDIndicatorManagerComponent : public UGameStateComponent
@@ -44,16 +166,27 @@ public:
 	UHUDIndicatorManagerComponent(const FObjectInitializer& Initializer);
 
 	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+	// ~Begin UObject Interface
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	// ~End UObject Interface
 	
 	// ~Begin ActorComponent Interface
+	virtual void OnRegister() override;
 	virtual void OnUnregister() override;
 	// ~End ActorComponent Interface
 
 	UFUNCTION(BlueprintCallable, Category = "Components", DisplayName = "Get Indicator Manager Component", meta = (WorldContext = "WorldContextObject", DefaultToSelf = "WorldContextObject"))
 	static UHUDIndicatorManagerComponent* Get(const UObject* WorldContextObject);
 
-	FIndicatorDelegate OnIndicatorAdded;
-	FIndicatorDelegate OnIndicatorRemoved;
+	/** Broadcast for indicators of any category */
+	FIndicatorListDelegate OnIndicatorsAdded;
+	FIndicatorListDelegate OnIndicatorsRemoved;
+
+	/** @return delegate broadcast only for added indicators of @CategoryTag category */
+	FIndicatorListDelegate& OnCategoryIndicatorsAdded(FGameplayTag CategoryTag);
+	/** @return delegate broadcast only for removed indicators of @CategoryTag category */
+	FIndicatorListDelegate& OnCategoryIndicatorsRemoved(FGameplayTag CategoryTag);
 	
 	void AddIndicator(const UHUDIndicatorDescriptor* Descriptor, const AActor* OwnerActor);
 	void AddIndicator(const UHUDIndicatorDescriptor* Descriptor, const USceneComponent* Component, FName SocketName = NAME_None);
@@ -61,17 +194,135 @@ public:
 	void AddIndicatorWithContext(const UHUDIndicatorDescriptor* Descriptor, const AActor* OwnerActor, const FHUDWidgetContextHandle& WidgetContext);
 	void AddIndicatorWithContext(const UHUDIndicatorDescriptor* Descriptor, const USceneComponent* Component, FName SocketName, const FHUDWidgetContextHandle& WidgetContext);
 
+	/** Add indicator with the same descriptor for each of @OwnerActors, with a single OnIndicatorsAdded broadcast */
+	void AddIndicators(const UHUDIndicatorDescriptor* Descriptor, TConstArrayView<const AActor*> OwnerActors);
+	void AddIndicators(const UHUDIndicatorDescriptor* Descriptor, TConstArrayView<const USceneComponent*> Components, FName SocketName = NAME_None);
+
 	void RemoveIndicators(const AActor* OwnerActor);
 	void RemoveIndicators(const USceneComponent* Component);
+
+	/** Remove indicators of each of @OwnerActors, with a single OnIndicatorsRemoved broadcast */
+	void RemoveIndicators(TConstArrayView<const AActor*> OwnerActors);
+	void RemoveIndicators(TConstArrayView<const USceneComponent*> Components);
+
+	/** Add indicator at fixed @WorldLocation, without any target actor or component */
+	FHUDIndicatorHandle AddIndicatorAtLocation(const UHUDIndicatorDescriptor* Descriptor, const FVector& WorldLocation, const FHUDWidgetContextHandle& WidgetContext = {});
+	/** Add indicator that follows location of @LocationProvider */
+	FHUDIndicatorHandle AddIndicatorWithProvider(const UHUDIndicatorDescriptor* Descriptor, const TSharedRef<IHUDIndicatorLocationProvider>& LocationProvider, const FHUDWidgetContextHandle& WidgetContext = {});
+	/** Add indicator with the same descriptor at each of @WorldLocations, with a single OnIndicatorsAdded broadcast */
+	void AddIndicatorsAtLocations(const UHUDIndicatorDescriptor* Descriptor, TConstArrayView<FVector> WorldLocations, TArray<FHUDIndicatorHandle>& OutHandles);
+
+	/** Move indicator added at fixed world location. Replicated handles are forwarded to SetReplicatedIndicatorLocation */
+	void SetIndicatorLocation(const FHUDIndicatorHandle& Handle, const FVector& WorldLocation);
+
+	/** Remove indicator by handle. Replicated handles are forwarded to RemoveReplicatedIndicator */
+	void RemoveIndicator(const FHUDIndicatorHandle& Handle);
+	/** Remove positional indicators of each of @Handles, with a single OnIndicatorsRemoved broadcast */
+	void RemoveIndicators(TConstArrayView<FHUDIndicatorHandle> Handles);
+
+	/**
+	 * Add indicator replicated to every client, server only. Requires @bReplicateIndicators
+	 * Listen server gets a local indicator immediately, dedicated server keeps only the replicated entry
+	 */
+	FHUDIndicatorHandle AddReplicatedIndicator(const UHUDIndicatorDescriptor* Descriptor, const USceneComponent* Component, FName SocketName = NAME_None, const FHUDWidgetContextHandle& WidgetContext = {});
+	FHUDIndicatorHandle AddReplicatedIndicatorAtLocation(const UHUDIndicatorDescriptor* Descriptor, const FVector& WorldLocation, const FHUDWidgetContextHandle& WidgetContext = {});
+	
+	/** Move positional replicated indicator, server only */
+	void SetReplicatedIndicatorLocation(const FHUDIndicatorHandle& Handle, const FVector& WorldLocation);
+	/** Remove replicated indicator, server only */
+	void RemoveReplicatedIndicator(const FHUDIndicatorHandle& Handle);
+
+	/** @return indicator widget context allocated from manager's context arena */
+	FHUDWidgetContextHandle CreateWidgetContext(UObject* ContextObject, const UHUDIndicatorDescriptor* Descriptor);
 	
 	FORCEINLINE const TSet<TSharedPtr<FIndicatorDescriptorInstance>>& GetIndicators() const
 	{
 		return IndicatorInstances;
 	}
 
+	/** @return indicators of @CategoryTag category */
+	const TSet<TSharedPtr<FIndicatorDescriptorInstance>>& GetIndicators(FGameplayTag CategoryTag) const;
+
 protected:
 
-	void AddIndicatorInternal(TSharedPtr<FIndicatorDescriptorInstance> Instance);
+	/** broadcast @Instances to global and category delegates */
+	void BroadcastIndicatorsAdded(TConstArrayView<TSharedRef<FIndicatorDescriptorInstance>> Instances);
+	void BroadcastIndicatorsRemoved(TConstArrayView<TSharedRef<FIndicatorDescriptorInstance>> Instances);
+	
+	/** add @Instance to the manager without broadcasting it */
+	void AddIndicatorInternal(const TSharedRef<FIndicatorDescriptorInstance>& Instance);
+	/** create positional indicator instance with @Handle and add it to the manager without broadcasting it */
+	TSharedRef<FIndicatorDescriptorInstance> AddPositionalIndicatorInternal(const FHUDIndicatorHandle& Handle, const UHUDIndicatorDescriptor* Descriptor, const FHUDWidgetContextHandle& WidgetContext);
+	/** remove indicator from every manager index */
+	void RemoveIndicatorInternal(const TSharedRef<FIndicatorDescriptorInstance>& Instance);
+
+	/** @return new handle for a local or a replicated indicator */
+	FHUDIndicatorHandle AllocateIndicatorHandle(bool bReplicated);
+
+	/**
+	 * Reset local instances of replicated entries that were removed by actor or component
+	 * Entry doesn't own removed instance anymore, so its removal is not broadcast again when server removes the entry
+	 */
+	void ReleaseRemovedReplicatedInstances();
+	/** @return whether replicated indicators can be modified by this manager, logs error otherwise */
+	bool CanModifyReplicatedIndicators(const TCHAR* FunctionName) const;
+	/** remove replicated entry by @Handle. @return local indicator of the entry, it is neither removed from the manager nor broadcast */
+	TSharedPtr<FIndicatorDescriptorInstance> RemoveReplicatedEntry(const FHUDIndicatorHandle& Handle);
+	/** add replicated indicator entry, and its local indicator unless running a dedicated server */
+	FHUDIndicatorHandle AddReplicatedIndicatorInternal(FHUDReplicatedIndicator&& NewEntry);
+	/** create local indicator for replicated @Entry without broadcasting it. Fails if entry target is not mapped yet */
+	TSharedPtr<FIndicatorDescriptorInstance> CreateReplicatedInstance(const FHUDReplicatedIndicator& Entry);
+
+	/** start stale indicator sweep timer if it is not running yet */
+	void StartStaleIndicatorSweep();
+	/** remove indicators of destroyed components, stops sweep timer once there are no component indicators left */
+	void RemoveStaleIndicators();
+
+	/**
+	 * Interval in seconds between sweeps that remove indicators of destroyed components
+	 * Indicators should be removed explicitly, sweep only catches indicators of actors destroyed without removing them
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Indicators", meta = (ClampMin = 0.1, Units = "s"))
+	float StaleIndicatorSweepInterval = 1.f;
+	
+	FTimerHandle StaleIndicatorSweepTimer;
+
+	/** Enables replicated indicator list. Indicators added locally are never replicated */
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	bool bReplicateIndicators = false;
+
+	UPROPERTY(Replicated)
+	FHUDReplicatedIndicatorList ReplicatedIndicators;
+
+	friend FHUDReplicatedIndicatorList;
+
+	template <typename TAllocator>
+	void RemoveIndicatorsByActor(const AActor* OwnerActor, TArray<TSharedRef<FIndicatorDescriptorInstance>, TAllocator>& OutInstances);
+	template <typename TAllocator>
+	void RemoveIndicatorsByComponent(const TObjectKey<const USceneComponent>& ComponentKey, TArray<TSharedRef<FIndicatorDescriptorInstance>, TAllocator>& OutInstances);
+	
+	using FIndicatorInstanceList = TArray<TSharedRef<FIndicatorDescriptorInstance>, TInlineAllocator<2>>;
 	
 	TSet<TSharedPtr<FIndicatorDescriptorInstance>> IndicatorInstances;
+
+	/** indicators indexed by owning actor and by component, so removal doesn't iterate all indicators */
+	TMap<TObjectKey<const AActor>, FIndicatorInstanceList> IndicatorsByActor;
+	TMap<TObjectKey<const USceneComponent>, FIndicatorInstanceList> IndicatorsByComponent;
+	/** positional indicators, they are not indexed by actor and component */
+	TMap<FHUDIndicatorHandle, TSharedRef<FIndicatorDescriptorInstance>> IndicatorsByHandle;
+	uint32 LastIndicatorHandleId = 0;
+	uint32 LastReplicatedIndicatorHandleId = 0;
+
+	/** indicators and subscribers of a single indicator category */
+	struct FIndicatorCategory
+	{
+		TSet<TSharedPtr<FIndicatorDescriptorInstance>> Indicators;
+		FIndicatorListDelegate OnIndicatorsAdded;
+		FIndicatorListDelegate OnIndicatorsRemoved;
+	};
+	/** indicator categories by category tag, categories are kept for the manager lifetime */
+	TMap<FGameplayTag, FIndicatorCategory> Categories;
+
+	/** Indicators are added in bursts, allocate their widget contexts in chunks */
+	THUDWidgetContextArena<FIndicatorWidgetContext> ContextArena;
 };
@@ -6,6 +6,9 @@ struct HUDFRAMEWORK_API FIndicatorProjectionResult
 {
 	/** Screen position with depth in format { ScreenPos.X, ScreenPos.Y, Depth }*/
 	FVector ScreenPositionWithDepth = FVector::ZeroVector;
+
+	/** World location indicator was projected from, used as occlusion trace target */
+	FVector WorldLocation = FVector::ZeroVector;
 	
 	bool bSuccess = false;
 };
@@ -26,6 +29,16 @@ public:
 	 */
 	virtual void Project(const USceneComponent* Component, const FName& SocketName, const FLocalPlayerContext& PlayerContext, const FVector2f& ScreenSize, FIndicatorProjectionResult& Result) const {}
 
+	/**
+	 * Override this function to define how position of positional indicator calculates in this projection mode.
+	 * Positional indicators have no target component, implementation should not access any target UObject.
+	 * @param WorldLocation World location of indicator
+	 * @param PlayerContext Context of local player
+	 * @param ScreenSize Size that was allotted for indicators screen
+	 * @param Result Out calculated result. NOTE: OutResult.bSuccess must be true only if position calculated successfully.
+	 */
+	virtual void ProjectWorldLocation(const FVector& WorldLocation, const FLocalPlayerContext& PlayerContext, const FVector2f& ScreenSize, FIndicatorProjectionResult& Result) const {}
+
 protected:
 	/**
 	 * Method for validate data passed to Project(...) function. Simply call it at the beginning of function.
@@ -0,0 +1,71 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "HUDWidgetContext.h"
+
+#include "HUDIndicatorTypes.generated.h"
+
+class UHUDIndicatorDescriptor;
+
+USTRUCT(BlueprintType)
+struct FIndicatorWidgetContext: public FHUDWidgetContextBase
+{
+	GENERATED_BODY()
+
+	FIndicatorWidgetContext() = default;
+	FIndicatorWidgetContext(UObject* InContextObject, const UHUDIndicatorDescriptor* InDescriptor)
+		: ContextObject(InContextObject)
+		, Descriptor(InDescriptor)
+	{}
+	
+	UPROPERTY(BlueprintReadWrite)
+	UObject* ContextObject = nullptr;
+
+	UPROPERTY(BlueprintReadWrite)
+	const UHUDIndicatorDescriptor* Descriptor = nullptr;
+};
+
+/**
+ * Handle to a positional indicator, i.e. an indicator that doesn't target a scene component, or to a replicated indicator
+ * Replicated handles are allocated by server and are the same on every machine
+ */
+USTRUCT(BlueprintType)
+struct HUDFRAMEWORK_API FHUDIndicatorHandle
+{
+	GENERATED_BODY()
+
+	FHUDIndicatorHandle() = default;
+
+	FORCEINLINE bool IsValid() const { return Id != 0; }
+	FORCEINLINE void Invalidate() { Id = 0; }
+	FORCEINLINE bool IsReplicated() const { return (Id & ReplicatedBit) != 0; }
+
+	friend FORCEINLINE bool operator==(const FHUDIndicatorHandle& Lhs, const FHUDIndicatorHandle& Rhs)
+	{
+		return Lhs.Id == Rhs.Id;
+	}
+
+	friend FORCEINLINE bool operator!=(const FHUDIndicatorHandle& Lhs, const FHUDIndicatorHandle& Rhs)
+	{
+		return Lhs.Id != Rhs.Id;
+	}
+
+	friend FORCEINLINE uint32 GetTypeHash(const FHUDIndicatorHandle& Handle)
+	{
+		return ::GetTypeHash(Handle.Id);
+	}
+
+private:
+
+	/** set for handles of replicated indicators, so they never collide with handles allocated locally */
+	static constexpr uint32 ReplicatedBit = 1u << 31;
+
+	explicit FHUDIndicatorHandle(uint32 InId)
+		: Id(InId)
+	{}
+	
+	UPROPERTY()
+	uint32 Id = 0;
+
+	friend class UHUDIndicatorManagerComponent;
+};
@@ -3,9 +3,11 @@
 #include "AsyncMixin.h"
 #include "GameplayTagContainer.h"
 #include "HUDWidgetPool.h"
+#include "HUDIndicatorCanvasWidget.h"
 #include "HUDIndicatorDescriptor.h"
 #include "HUDIndicatorManagerComponent.h"
 #include "HUDIndicatorProjectionMode.h"
+#include "WorldCollision.h"
 #include "Blueprint/UserWidgetPool.h"
 
 class UHUDWidgetContextSubsystem;
@@ -13,29 +15,52 @@ class UHUDIndicatorManagerComponent;
 struct FIndicatorDescriptorInstance;
 
 
-class SIndicatorCanvasArrowWidget : public SLeafWidget
+/**
+ * Indicators clamped during a single canvas update
+ * Stored as a structure of arrays, so clamp loops run over tightly packed data without branching on clamp shape
+ */
+struct FIndicatorClampBatch
 {
-public:
-	SLATE_BEGIN_ARGS(SIndicatorCanvasArrowWidget) {}
-	SLATE_END_ARGS()
-
-	SIndicatorCanvasArrowWidget() {}
+	void Reset()
+	{
+		SlotIndexes.Reset();
+		Positions.Reset();
+		Centers.Reset();
+		Extents.Reset();
+	}
 
-	// ~Begin SWidget Interface
-	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
-	virtual FVector2D ComputeDesiredSize(float) const override;
-	// ~End SWidget Interface
+	void Add(int32 SlotIndex, const FVector2f& Position, const FVector2f& Center, const FVector2f& Extent)
+	{
+		SlotIndexes.Add(SlotIndex);
+		Positions.Add(Position);
+		Centers.Add(Center);
+		Extents.Add(Extent);
+	}
 
-	void Construct(const FArguments& InArgs, const FSlateBrush* InArrowBrush);
+	FORCEINLINE int32 Num() const { return SlotIndexes.Num(); }
 
-	FORCEINLINE void SetRotation(float InRotation)
+	/** resize outputs to match inputs */
+	void PrepareOutputs()
 	{
-		Rotation = FMath::Fmod(InRotation, 360.f);
+		ClampedPositions.SetNumUninitialized(Num(), EAllowShrinking::No);
+		Directions.SetNumUninitialized(Num(), EAllowShrinking::No);
+		Rotations.SetNumUninitialized(Num(), EAllowShrinking::No);
 	}
 
-private:
-	const FSlateBrush* ArrowBrush = nullptr;
-	float Rotation = 0.f;
+	// Inputs
+	TArray<int32> SlotIndexes;
+	/** indicator screen positions */
+	TArray<FVector2f> Positions;
+	/** centers and half sizes of the clamp rectangle, different per indicator because of indicator size and alignment */
+	TArray<FVector2f> Centers;
+	TArray<FVector2f> Extents;
+	
+	// Outputs
+	TArray<FVector2f> ClampedPositions;
+	/** screen edge indicator was clamped to, invalid direction if indicator wasn't clamped */
+	TArray<uint8> Directions;
+	/** arrow rotations in degrees */
+	TArray<float> Rotations;
 };
 
 #define INDICATOR_SLOT_SETTER_IMPL(VariableName, VariableNewValue) \
@@ -60,8 +85,8 @@ public:
 			  IndicatorUserWidget(InUserWidget),
 			  bHasValidScreenPosition(false),
 			  bWasIndicatorClamped(false),
-			  bDirty(true),
-			  bWasIndicatorClampedStatusChanged(false)
+			  bOccluded(false),
+			  bDirty(true)
 		{
 		}
 
@@ -80,48 +105,38 @@ public:
 			return IndicatorUserWidget;
 		}
 
-		FORCEINLINE_DEBUGGABLE bool ShouldSkipIndicator() const
-		{
-			bool bSkip = false;
-			bSkip |= WasUserWidgetManuallyCollapsed() | FMath::IsNearlyZero(GetIndicatorScale()) | !IsValid(IndicatorDescriptorInstance->Component);
-
-			if (!bSkip && !IndicatorDescriptorInstance->Descriptor->bDisplayIndicatorWhenComponentCanNotRender)
-			{
-				bSkip |= !IndicatorDescriptorInstance->Component->CanEverRender();
-			}
-			return bSkip;
-		}
-		
 		FORCEINLINE const FVector2D& GetScreenPosition() const { return ScreenPosition; }
 		FORCEINLINE void SetScreenPosition(const FVector2D& InValue) { INDICATOR_SLOT_SETTER_IMPL(ScreenPosition, InValue); }
 		FORCEINLINE double GetDepth() const { return Depth; }
-		FORCEINLINE void SetDepth(double InValue) { INDICATOR_SLOT_SETTER_IMPL(Depth, InValue); }
+		FORCEINLINE void SetDepth(double InValue)
+		{
+			INDICATOR_SLOT_SETTER_IMPL(Depth, InValue);
+			
+			IndicatorScale = GetRuntimeData().GetScale(Depth);
+		}
 		FORCEINLINE int32 GetPriority() const { return Priority; }
 		FORCEINLINE void SetPriority(int32 InValue) { INDICATOR_SLOT_SETTER_IMPL(Priority, InValue); }
 		
 		FORCEINLINE bool HasValidScreenPosition() const { return bHasValidScreenPosition; }
-		FORCEINLINE void SetHasValidScreenPosition(bool InValue)
-		{
-			INDICATOR_SLOT_SETTER_IMPL(bHasValidScreenPosition, InValue);
-			
-			GetWidget()->SetVisibility(bHasValidScreenPosition ? EVisibility::SelfHitTestInvisible : EVisibility::Collapsed);
-		}
+		/** indicators without valid screen position are filtered out during arrange, widget visibility is not changed */
+		FORCEINLINE void SetHasValidScreenPosition(bool InValue) { INDICATOR_SLOT_SETTER_IMPL(bHasValidScreenPosition, InValue); }
 		
 		FORCEINLINE bool WasIndicatorClamped() const { return bWasIndicatorClamped; }
-		FORCEINLINE void SetWasIndicatorClamped(bool InValue) const
-		{
-			if (bWasIndicatorClamped != InValue)
-			{
-				bWasIndicatorClamped = InValue;
-				bWasIndicatorClampedStatusChanged = true;
-			}
-		}
+		FORCEINLINE void SetWasIndicatorClamped(bool InValue) { INDICATOR_SLOT_SETTER_IMPL(bWasIndicatorClamped, InValue); }
+		/** clamp results are valid only if indicator was clamped */
+		FORCEINLINE const FVector2D& GetClampedScreenPosition() const { return ClampedScreenPosition; }
+		FORCEINLINE void SetClampedScreenPosition(const FVector2D& InValue) { INDICATOR_SLOT_SETTER_IMPL(ClampedScreenPosition, InValue); }
+		FORCEINLINE uint8 GetClampDirection() const { return ClampDirection; }
+		FORCEINLINE void SetClampDirection(uint8 InValue) { INDICATOR_SLOT_SETTER_IMPL(ClampDirection, InValue); }
+		FORCEINLINE float GetArrowRotation() const { return ArrowRotation; }
+		FORCEINLINE void SetArrowRotation(float InValue) { INDICATOR_SLOT_SETTER_IMPL(ArrowRotation, InValue); }
+		
+		FORCEINLINE bool IsOccluded() const { return bOccluded; }
+		FORCEINLINE void SetOccluded(bool InValue) { INDICATOR_SLOT_SETTER_IMPL(bOccluded, InValue); }
 		
 		// Flags
 		FORCEINLINE bool IsDirty() const { return bDirty; }
 		FORCEINLINE void ClearDirtyFlag() { bDirty = false; }
-		FORCEINLINE bool WasIndicatorClampedStatusChanged() const { return bWasIndicatorClampedStatusChanged; }
-		FORCEINLINE void ClearIndicatorClampedStatusChangedFlag() const { bWasIndicatorClampedStatusChanged = false; }
 		// ~End Getters && Setters
 
 		FORCEINLINE bool WasUserWidgetManuallyCollapsed() const
@@ -129,16 +144,15 @@ public:
 			return GetUserWidget()->GetVisibility() == ESlateVisibility::Collapsed;
 		}
 
+		FORCEINLINE const FHUDIndicatorDescriptorRuntimeData& GetRuntimeData() const
+		{
+			return IndicatorDescriptorInstance->Descriptor->GetRuntimeData();
+		}
+
+		/** scale is sampled from the descriptor scale LUT when depth changes */
 		FORCEINLINE float GetIndicatorScale() const
 		{
-			const UHUDIndicatorDescriptor* Descriptor = IndicatorDescriptorInstance->Descriptor;
-			check(Descriptor != nullptr);
-
-			if (Descriptor->bEnableScaling && Descriptor->ScaleCurve != nullptr)
-			{
-				return Descriptor->ScaleCurve->GetFloatValue(GetDepth());
-			}
-			return 1.f;
+			return IndicatorScale;
 		}
 
 	private:
@@ -149,17 +163,17 @@ public:
 		TWeakObjectPtr<UUserWidget> IndicatorUserWidget;
 		FVector2D ScreenPosition = FVector2D::ZeroVector;
 		double Depth = 0.;
+		float IndicatorScale = 1.f;
 		int32 Priority = 0;
+		// Clamp results, calculated during canvas update
+		FVector2D ClampedScreenPosition = FVector2D::ZeroVector;
+		float ArrowRotation = 0.f;
+		uint8 ClampDirection = 0;
 		uint8 bHasValidScreenPosition : 1;
-		mutable uint8 bWasIndicatorClamped : 1; // Saved during const ArrangeChildren operation
+		uint8 bWasIndicatorClamped : 1;
+		uint8 bOccluded : 1;
 		// Flags
 		uint8 bDirty : 1;
-		mutable uint8 bWasIndicatorClampedStatusChanged : 1; // Saved during const ArrangeChildren operation
-	};
-
-	//Slot for arrow
-	class FArrowSlot : public TSlotBase<FArrowSlot>
-	{
 	};
 
 	SLATE_BEGIN_ARGS(SIndicatorCanvas)
@@ -167,14 +181,11 @@ public:
 		_Visibility = EVisibility::HitTestInvisible;
 	}
 		SLATE_SLOT_ARGUMENT(SIndicatorCanvas::FSlot, Slots)
+		SLATE_ARGUMENT(FHUDIndicatorCanvasSettings, Settings)
 	SLATE_END_ARGS()
 
-	SIndicatorCanvas() : SlotChildren(this),
-	                     ArrowChildren(this),
-	                     AllChildren(this)
+	SIndicatorCanvas() : SlotChildren(this)
 	{
-		AllChildren.AddChildren(SlotChildren);
-		AllChildren.AddChildren(ArrowChildren);
 	}
 
 	void Construct(const FArguments& InArgs, const FLocalPlayerContext& InLocalPlayerContext, const FGameplayTagContainer& InCategoryTags, const FSlateBrush* InArrowBrush);
@@ -183,7 +194,7 @@ public:
 	virtual void OnArrangeChildren(const FGeometry& AllottedGeometry, FArrangedChildren& ArrangedChildren) const override;
 	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
 	virtual FVector2D ComputeDesiredSize(float) const override { return FVector2D::ZeroVector; };
-	virtual FChildren* GetChildren() override { return &AllChildren; };
+	virtual FChildren* GetChildren() override { return &SlotChildren; };
 	// ~End SWidget Interface
 
 	void SetWidgetPool(FHUDWidgetPool* InPool)
@@ -199,10 +210,28 @@ protected:
 
 	void UpdateActiveTimer();
 	EActiveTimerReturnType UpdateCanvas(double InCurrentTime, float InDeltaTime);
+
+	/** @return whether indicator with projection @Result passes visibility, distance and occlusion checks */
+	virtual bool IsIndicatorVisible(const FIndicatorDescriptorInstance& Instance, const FIndicatorProjectionResult& Result, const FVector2f& ScreenSize, bool bOccluded) const;
 	
 private:
-	void HandleIndicatorAdded(const TSharedRef<FIndicatorDescriptorInstance>& IndicatorInstance);
-	void HandleIndicatorRemoved(const TSharedRef<FIndicatorDescriptorInstance>& IndicatorInstance);
+	void HandleIndicatorsAdded(TConstArrayView<TSharedRef<FIndicatorDescriptorInstance>> IndicatorInstances);
+	void HandleIndicatorsRemoved(TConstArrayView<TSharedRef<FIndicatorDescriptorInstance>> IndicatorInstances);
+
+	/** create widget of a loaded @IndicatorWidgetClass for @IndicatorInstance and add it to a new indicator slot */
+	void CreateIndicatorWidget(const TSharedRef<FIndicatorDescriptorInstance>& IndicatorInstance, TSubclassOf<UUserWidget> IndicatorWidgetClass);
+	/** release widget of the indicator slot back to the pool and remove the slot */
+	void ReleaseIndicatorWidget(int32 SlotIndex);
+
+	/** load widget classes and create widgets for tracked indicators at @TrackedIndexes */
+	void MaterializeIndicators(TConstArrayView<int32> TrackedIndexes);
+	void DematerializeIndicator(int32 TrackedIndex);
+	void RemoveTrackedIndicator(int32 TrackedIndex);
+
+	/** read occlusion trace results issued during previous frames */
+	void ReadOcclusionResults();
+	/** issue occlusion traces for the most urgent occlusion candidates within the per frame budget */
+	void IssueOcclusionTraces(double CurrentTime);
 	
 	using FScopedWidgetSlotArguments = TPanelChildren<FSlot>::FScopedWidgetSlotArguments;
 	FScopedWidgetSlotArguments AddIndicatorSlot(const TSharedRef<FIndicatorDescriptorInstance>& IndicatorInstance, UUserWidget* IndicatorWidget);
@@ -213,53 +242,115 @@ private:
 	void OnIndicatorManagerChanged();
 
 	/** Returns true if one or more indicators have been changed. */
-	bool UpdateIndicators();
+	bool UpdateIndicators(double CurrentTime);
 
-	uint8 ClampIndicator(const FSlot& IndicatorSlot, const FVector2D& ScreenSize, OUT FVector2D& OutClampedScreenPosition) const;
+	/** clamp stage of the canvas update, clamps indicators to the screen area and stores results in their slots */
+	void ClampIndicators(const FVector2f& ScreenSize);
 	
-	/* Scoped array for correct arrow slot managing. Can be used in const functions. */
-	struct FScopedArrowChildren
+	/** Clamp arrow emitted by arrange and drawn by paint */
+	struct FArrowInstance
 	{
-		// Pass pointer on const value because arrow processing happens during ArrangeChildren const operation.
-		FScopedArrowChildren(const TPanelChildren<FArrowSlot>* ArrowChildren, const FSlateBrush* ArrowBrush) :
-			ArrowChildren(*(const_cast<TPanelChildren<FArrowSlot>*>(ArrowChildren))),
-			ArrowBrush(ArrowBrush)
-		{
-		}
-		
-		~FScopedArrowChildren();
+		FVector2D Position = FVector2D::ZeroVector;
+		float Rotation = 0.f;
+		const FSlateBrush* Brush = nullptr;
+	};
 
-		// Gets next arrow widget from children if exists, otherwise adds new slot to children and returns its widget.
-		TSharedRef<SIndicatorCanvasArrowWidget> GetOrCreateArrowChild();
+	/** @return arrow brush for indicators with @Descriptor */
+	const FSlateBrush* GetArrowBrush(const UHUDIndicatorDescriptor* Descriptor) const;
+	void AddArrow(const FSlateBrush* Brush, uint8 InArrowDirection, float ArrowRotation, const FVector2D& IndicatorPosition, const FVector2D& IndicatorSize, float IndicatorVAlignment) const;
 
-	private:
-		// Maximum inactive arrow slots.
-		static constexpr int32 MAX_INACTIVE_ARROWS = 3;
-
-		// Index of next arrow that will be returned
-		int32 Index = 0;
-		// Ref to canvas arrow children
-		TPanelChildren<FArrowSlot>& ArrowChildren;
-		// Slate brush for new arrow widgets
-		const FSlateBrush* ArrowBrush = nullptr;
-
-		FScopedArrowChildren(const FScopedArrowChildren&) = delete;
-		FScopedArrowChildren(const FScopedArrowChildren&&) = delete;
-		FScopedArrowChildren& operator=(const FScopedArrowChildren&) = delete;
+	/** Arranged indicator in paint order, indicators with the same group key are painted together */
+	struct FPaintEntry
+	{
+		int32 ChildIndex = INDEX_NONE;
+		uint64 GroupKey = 0;
 	};
-	
-	void AddArrowWidget(const FGeometry& AllottedGeometry, FArrangedChildren& ToArrangedChildren, FScopedArrowChildren& FromScopedChildren, uint8 InArrowDirection,  const FVector2D& IndicatorPosition, const FVector2D& IndicatorSize, EVerticalAlignment IndicatorVAlignment) const;
+
+	/** fill PaintEntries for arranged indicators, grouped by descriptor if @bGroupPaintLayers is set */
+	void BuildPaintEntries(bool bGroupPaintLayers) const;
+
+	/** Arrange result of a single sorted slot */
+	struct FArrangeEntry
+	{
+		FSlateLayoutTransform Transform;
+		FVector2D Size = FVector2D::ZeroVector;
+		bool bSkip = true;
+	};
+
+	/**
+	 * Arrange slots at @SortedIndexes of SortedSlots and write results to ArrangeEntries
+	 * Instantiated per descriptor feature set, so feature checks of @TFeatures are compile time constants
+	 */
+	template <typename TFeatures>
+	void ArrangeSlots(TConstArrayView<int32> SortedIndexes, const FArrangedChildren& ArrangedChildren) const;
 
 protected:
 	mutable TOptional<FGeometry> CachedAllottedGeometry;
 
+	/** Storage reused by OnArrangeChildren and OnPaint, so arranging indicators doesn't allocate every frame */
+	mutable TArray<const FSlot*> SortedSlots;
+	mutable FArrangedChildren CachedArrangedChildren{EVisibility::Visible};
+	/** Arrows of clamped indicators, reused between frames */
+	mutable TArray<FArrowInstance> ArrowInstances;
+	/** Arrange results and sorted slot indexes grouped by descriptor feature set */
+	mutable TArray<FArrangeEntry> ArrangeEntries;
+	mutable TArray<int32> ArrangeOrder;
+	mutable TArray<uint8> ArrangeFeatures;
+	/** Slots of arranged children, in arrange order */
+	mutable TArray<const FSlot*> ArrangedSlots;
+	mutable TArray<FPaintEntry> PaintEntries;
+	mutable TMap<const UHUDIndicatorDescriptor*, int32> PaintGroupIndices;
+
 private:
+	enum class EIndicatorState : uint8
+	{
+		/** indicator is only projected */
+		Tracked,
+		/** indicator widget class is loading */
+		Loading,
+		/** indicator owns a widget in one of the indicator slots */
+		Materialized
+	};
+	
+	struct FTrackedIndicator
+	{
+		explicit FTrackedIndicator(const TSharedRef<FIndicatorDescriptorInstance>& InInstance)
+			: Instance(InInstance)
+		{}
+		
+		TSharedRef<FIndicatorDescriptorInstance> Instance;
+		/** last time indicator passed visibility checks */
+		double LastVisibleTime = 0.;
+		/** depth of the last projection, used to materialize closest indicators first */
+		double Depth = 0.;
+		/** world location of the last projection */
+		FVector WorldLocation = FVector::ZeroVector;
+		/** pending occlusion trace, results are read during the next frames */
+		FTraceHandle OcclusionTrace;
+		double LastOcclusionTestTime = 0.;
+		EIndicatorState State = EIndicatorState::Tracked;
+		bool bOccluded = false;
+	};
+
+	FHUDIndicatorCanvasSettings Settings;
+
+	/** every indicator of the canvas categories */
+	TArray<FTrackedIndicator> TrackedIndicators;
+	/** indicator instance to its index in TrackedIndicators */
+	TMap<const FIndicatorDescriptorInstance*, int32> TrackedIndices;
+	/** storage reused by UpdateIndicators */
+	TArray<int32> MaterializeCandidates;
+	TArray<int32> DematerializeCandidates;
+	TArray<int32> OcclusionCandidates;
+	FIndicatorClampBatch ClampBatch;
+	
 	TPanelChildren<FSlot> SlotChildren;
-	TPanelChildren<FArrowSlot> ArrowChildren;
-	FCombinedChildren AllChildren;
+	/** indicator instance to its slot index in SlotChildren */
+	TMap<const FIndicatorDescriptorInstance*, int32> SlotIndices;
 
 	FLocalPlayerContext LocalPlayerContext;
 	FHUDWidgetPool* IndicatorPool = nullptr;
+	/** default arrow brush, used by descriptors that don't override it */
 	const FSlateBrush* ArrowBrush = nullptr;
 
 	FGameplayTagContainer CategoryTags;
@@ -18,7 +18,11 @@ public:
 
 	static FVector2D CalculateScreenPosition(const FSceneViewProjectionData& ProjectionData, const FVector& WorldLocation, const FVector2f& ScreenSize, const FVector2D& ScreenSpaceOffset);
 
+	/** project @WorldLocation with offsets applied */
+	static void ProjectPoint(const FVector& WorldLocation, const FVector& WorldLocationOffset, const FVector2D& ScreenSpaceOffset, const FLocalPlayerContext& PlayerContext, const FVector2f& ScreenSize, FIndicatorProjectionResult& Result);
+
 	virtual void Project(const USceneComponent* Component, const FName& SocketName, const FLocalPlayerContext& PlayerContext, const FVector2f& ScreenSize, FIndicatorProjectionResult& Result) const override;
+	virtual void ProjectWorldLocation(const FVector& WorldLocation, const FLocalPlayerContext& PlayerContext, const FVector2f& ScreenSize, FIndicatorProjectionResult& Result) const override;
 };
 
 UCLASS(DisplayName = "Component Bounding Box")
@@ -40,4 +44,6 @@ public:
 	bool bUseOwnerBoundingBox = false;
 
 	virtual void Project(const USceneComponent* Component, const FName& SocketName, const FLocalPlayerContext& PlayerContext, const FVector2f& ScreenSize, FIndicatorProjectionResult& Result) const override;
+	/** positional indicators have no bounding box, they are projected as a point */
+	virtual void ProjectWorldLocation(const FVector& WorldLocation, const FLocalPlayerContext& PlayerContext, const FVector2f& ScreenSize, FIndicatorProjectionResult& Result) const override;
 };
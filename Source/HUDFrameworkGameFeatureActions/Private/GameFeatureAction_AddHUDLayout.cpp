@@ -13,11 +13,13 @@ struct FHUDExtensionData
 {
 	TArray<TPair<UCommonActivatableWidget*, FGameplayTag>> LayoutWidgets;
 	TArray<FHUDLayoutExtensionHandle> ExtensionHandles;
+	/** primary layout ready delegate, valid while layouts are waiting for primary layout to be created */
+	FDelegateHandle LayoutReadyHandle;
 };
 
 struct FHUDLayoutContextData: public FGameExperienceActionState
 {
-	TMap<AActor*, FHUDExtensionData> ActiveExtensions;
+	TMap<AActor*, TSharedRef<FHUDExtensionData>> ActiveExtensions;
 };
 
 TSharedPtr<FGameExperienceActionState> UGameFeatureAction_AddHUDLayout::CreateActionState() const
@@ -51,7 +53,7 @@ void UGameFeatureAction_AddHUDLayout::RemoveFromWorld(const FWorldContext& World
 	for (auto& [Actor, ActorExtensions]: LayoutData.ActiveExtensions)
 	{
 		const AHUD* HUD = CastChecked<AHUD>(Actor);
-		RemoveWidgets(HUD->GetOwningPlayerController(), ActorExtensions);
+		RemoveWidgets(HUD->GetOwningPlayerController(), *ActorExtensions);
 	}
 	LayoutData.ActiveExtensions.Empty();
 
@@ -83,41 +85,59 @@ void UGameFeatureAction_AddHUDLayout::HandleActorExtension(AActor* Actor, FName
 	
 	if (Event == UGameFrameworkComponentManager::NAME_ExtensionAdded || Event == UGameFrameworkComponentManager::NAME_GameActorReady)
 	{
-		FHUDExtensionData& ExtensionData = ContextData.ActiveExtensions.Add(Actor);
+		const TSharedRef<FHUDExtensionData>& ExtensionData = ContextData.ActiveExtensions.Add(Actor, MakeShared<FHUDExtensionData>());
 		AddWidgets(PlayerController, ExtensionData);
 	}
 	else if (Event == UGameFrameworkComponentManager::NAME_ReceiverRemoved || Event == UGameFrameworkComponentManager::NAME_ExtensionRemoved)
 	{
-		FHUDExtensionData& ExtensionData = ContextData.ActiveExtensions.FindChecked(Actor);
+		FHUDExtensionData& ExtensionData = *ContextData.ActiveExtensions.FindChecked(Actor);
 		RemoveWidgets(PlayerController, ExtensionData);
 	}
 }
 
-void UGameFeatureAction_AddHUDLayout::AddWidgets(const APlayerController* PlayerController, FHUDExtensionData& ExtensionData) const
+void UGameFeatureAction_AddHUDLayout::AddWidgets(const APlayerController* PlayerController, const TSharedRef<FHUDExtensionData>& ExtensionData) const
 {
 	check(PlayerController);
 	UHUDLayoutSubsystem* LayoutSubsystem = PlayerController->GetGameInstance()->GetSubsystem<UHUDLayoutSubsystem>();
 	check(LayoutSubsystem);
 
-	if (UHUDPrimaryLayout* PrimaryLayout = UHUDLayoutBlueprintLibrary::GetPrimaryLayout(PlayerController))
+	// primary layout may still be loading, push layouts once it is created
+	ULocalPlayer* LocalPlayer = PlayerController->GetLocalPlayer();
+	ExtensionData->LayoutReadyHandle = LayoutSubsystem->CallOrRegister_OnPrimaryLayoutReady(LocalPlayer, FPrimaryLayoutReadyDelegate::FDelegate::CreateLambda(
+	[WeakThis = TWeakObjectPtr<const ThisClass>{this}, WeakData = TWeakPtr<FHUDExtensionData>{ExtensionData}](UHUDPrimaryLayout* PrimaryLayout)
 	{
-		for (const FHUDLayoutEntry& Layout: Layouts)
+		const ThisClass* This = WeakThis.Get();
+		if (TSharedPtr<FHUDExtensionData> Data = WeakData.Pin(); This && Data.IsValid())
 		{
-			check(Layout.LayoutClass.Get());
-			ExtensionData.LayoutWidgets.Emplace(PrimaryLayout->PushWidgetToLayer<UCommonActivatableWidget>(
-				Layout.LayerTag, Layout.LayoutClass.Get()), Layout.LayerTag
-			);
+			Data->LayoutReadyHandle.Reset();
+			This->PushLayouts(PrimaryLayout, *Data);
 		}
-	}
+	}));
 
 
-	ULocalPlayer* LocalPlayer = PlayerController->GetLocalPlayer();
+	TArray<FHUDLayoutExtensionParams> ExtensionParams;
+	ExtensionParams.Reserve(Extensions.Num());
 	for (const FHUDLayoutExtensionEntry& Extension: Extensions)
 	{
-		check(Extension.ExtensionWidgetClass.Get());
-		ExtensionData.ExtensionHandles.Add(LayoutSubsystem->RegisterLayoutExtension(
-			Extension.SlotTag, Extension.ExtensionWidgetClass.Get(), LocalPlayer
-		));
+		// widget classes are loaded with client bundle, otherwise slots load them asynchronously
+		FHUDLayoutExtensionParams& Params = ExtensionParams.AddDefaulted_GetRef();
+		Params.SlotTag = Extension.SlotTag;
+		Params.SoftWidgetClass = Extension.ExtensionWidgetClass;
+	}
+
+	// register all extensions first, so each slot is updated once
+	ExtensionData->ExtensionHandles.Append(LayoutSubsystem->RegisterLayoutExtensions(ExtensionParams, LocalPlayer));
+}
+
+void UGameFeatureAction_AddHUDLayout::PushLayouts(UHUDPrimaryLayout* PrimaryLayout, FHUDExtensionData& ExtensionData) const
+{
+	check(PrimaryLayout);
+	for (const FHUDLayoutEntry& Layout: Layouts)
+	{
+		check(Layout.LayoutClass.Get());
+		ExtensionData.LayoutWidgets.Emplace(PrimaryLayout->PushWidgetToLayer<UCommonActivatableWidget>(
+			Layout.LayerTag, Layout.LayoutClass.Get()), Layout.LayerTag
+		);
 	}
 }
 
@@ -127,7 +147,17 @@ void UGameFeatureAction_AddHUDLayout::RemoveWidgets(const APlayerController* Pla
 	UHUDLayoutSubsystem* LayoutSubsystem = PlayerController->GetGameInstance()->GetSubsystem<UHUDLayoutSubsystem>();
 	check(LayoutSubsystem);
 
-	if (UHUDPrimaryLayout* PrimaryLayout = UHUDLayoutBlueprintLibrary::GetPrimaryLayout(PlayerController))
+	if (ExtensionData.LayoutReadyHandle.IsValid())
+	{
+		LayoutSubsystem->Unregister_OnPrimaryLayoutReady(PlayerController->GetLocalPlayer(), ExtensionData.LayoutReadyHandle);
+		ExtensionData.LayoutReadyHandle.Reset();
+	}
+
+	UHUDPrimaryLayout* PrimaryLayout = UHUDLayoutBlueprintLibrary::GetPrimaryLayout(PlayerController);
+	// experience switch removes and adds layouts within the same frame, equivalent layouts and extensions reuse widgets on commit
+	LayoutSubsystem->BeginFrameTransaction(PrimaryLayout);
+	
+	if (PrimaryLayout != nullptr)
 	{
 		for (const auto& [Widget, LayerTag]: ExtensionData.LayoutWidgets)
 		{
@@ -136,10 +166,7 @@ void UGameFeatureAction_AddHUDLayout::RemoveWidgets(const APlayerController* Pla
 	}
 	ExtensionData.LayoutWidgets.Empty();
 	
-	for (FHUDLayoutExtensionHandle& Handle: ExtensionData.ExtensionHandles)
-	{
-		LayoutSubsystem->UnregisterLayoutExtension(Handle);
-	}
+	LayoutSubsystem->UnregisterLayoutExtensions(ExtensionData.ExtensionHandles);
 	ExtensionData.ExtensionHandles.Empty();
 }
 
@@ -9,6 +9,7 @@
 
 struct FHUDExtensionData;
 class UCommonActivatableWidget;
+class UHUDPrimaryLayout;
 
 USTRUCT()
 struct FHUDLayoutEntry
@@ -55,7 +56,8 @@ public:
 	
 protected:
 	void HandleActorExtension(AActor* Actor, FName Event, FGameFeatureStateChangeContext Context) const;
-	void AddWidgets(const APlayerController* PlayerController, FHUDExtensionData& ExtensionData) const;
+	void AddWidgets(const APlayerController* PlayerController, const TSharedRef<FHUDExtensionData>& ExtensionData) const;
+	void PushLayouts(UHUDPrimaryLayout* PrimaryLayout, FHUDExtensionData& ExtensionData) const;
 	void RemoveWidgets(const APlayerController* PlayerController, FHUDExtensionData& ExtensionData) const;
 
 	UPROPERTY(EditAnywhere, meta = (TitleProperty = "{LayoutClass} -> {LayerTag}"))
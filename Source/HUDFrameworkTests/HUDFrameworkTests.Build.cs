@@ -0,0 +1,29 @@
+﻿using UnrealBuildTool;
+
+public class HUDFrameworkTests : ModuleRules
+{
+    public HUDFrameworkTests(ReadOnlyTargetRules Target) : base(Target)
+    {
+        PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+        PublicDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "Core",
+            }
+        );
+
+        PrivateDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "CoreUObject",
+                "Engine",
+                "Slate",
+                "SlateCore",
+                "UMG",
+                "GameplayTags",
+                "HUDFramework",
+            }
+        );
+    }
+}
\ No newline at end of file
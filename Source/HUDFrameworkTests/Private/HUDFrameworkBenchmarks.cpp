@@ -0,0 +1,512 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HUDFrameworkTestIndicatorCanvas.h"
+#include "HUDFrameworkTestTypes.h"
+#include "HUDFrameworkTestWorld.h"
+#include "HUDLayoutExtension.h"
+#include "HUDLayoutSlot.h"
+#include "HUDLayoutSubsystem.h"
+#include "HUDWidgetContext.h"
+#include "HUDWidgetPool.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/SceneComponent.h"
+#include "Curves/CurveFloat.h"
+#include "Engine/LocalPlayer.h"
+#include "HAL/IConsoleManager.h"
+#include "Indicators/HUDIndicatorDescriptor.h"
+#include "Indicators/HUDIndicatorManagerComponent.h"
+#include "Indicators/HUDIndicatorTypes.h"
+#include "ViewModel/HUDWidgetContextExtension.h"
+#include "ViewModel/HUDWidgetContextSubsystem.h"
+
+/**
+ * Synthetic benchmarks for HUD Framework hot paths, run with -nullrhi to exclude rendering:
+ * -ExecCmds="Automation RunTests HUDFramework.Benchmarks; Quit"
+ * Each test logs results and appends them as CSV to Saved/Profiling/HUDFramework/Benchmarks.csv
+ */
+namespace HUDFrameworkTests
+{
+	constexpr uint32 BenchmarkFlags = EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter;
+
+	/** Remove widget context extensions from @UserWidget and every user widget of its widget tree */
+	void UnregisterWidgetTree(UUserWidget* UserWidget)
+	{
+		UserWidget->RemoveExtensions(UHUDWidgetContextExtension::StaticClass());
+		UserWidget->WidgetTree->ForEachWidget([](UWidget* Widget)
+		{
+			if (UUserWidget* ChildWidget = Cast<UUserWidget>(Widget))
+			{
+				UnregisterWidgetTree(ChildWidget);
+			}
+		});
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHUDFrameworkWidgetContextsBenchmark, "HUDFramework.Benchmarks.WidgetContexts", HUDFrameworkTests::BenchmarkFlags)
+
+/** Compare widget contexts allocated one by one with contexts allocated from an arena */
+bool FHUDFrameworkWidgetContextsBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HUDFrameworkTests;
+	
+	constexpr int32 Count = 10000;
+	TArray<FResult> Results;
+
+	TArray<FHUDWidgetContextHandle> Handles;
+	Handles.Reserve(Count);
+	{
+		FScopedMeasure Measure{Results, TEXT("WidgetContext_MakeShared"), Count};
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Handles.Add(FHUDWidgetContextHandle::CreateContext<FIndicatorWidgetContext>());
+		}
+	}
+	Handles.Reset();
+
+	{
+		THUDWidgetContextArena<FIndicatorWidgetContext> Arena;
+		FScopedMeasure Measure{Results, TEXT("WidgetContext_Arena"), Count};
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Handles.Add(Arena.CreateContext());
+		}
+	}
+	TestTrue(TEXT("Arena contexts are valid"), Handles.Num() == Count && Handles.Last().IsValid());
+	{
+		FScopedMeasure Measure{Results, TEXT("WidgetContext_ArenaRelease"), Count};
+		Handles.Reset();
+	}
+
+	ReportResults(Results);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHUDFrameworkIndicatorsBenchmark, "HUDFramework.Benchmarks.Indicators", HUDFrameworkTests::BenchmarkFlags)
+
+/** Add and remove indicators through indicator manager one by one and in bulk. Indicators have no category, so canvases ignore them */
+bool FHUDFrameworkIndicatorsBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HUDFrameworkTests;
+
+	FTestWorld TestWorld;
+	UHUDIndicatorManagerComponent* IndicatorManager = TestWorld.GetIndicatorManager();
+	
+	constexpr int32 Count = 1000;
+	TArray<FResult> Results;
+
+	UHUDIndicatorDescriptor* Descriptor = NewObject<UHUDIndicatorDescriptor>(GetTransientPackage());
+	TArray<const USceneComponent*> Components;
+	Components.Reserve(Count);
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		Components.Add(NewObject<USceneComponent>(GetTransientPackage()));
+	}
+
+	{
+		FScopedMeasure Measure{Results, TEXT("Indicators_Add"), Count};
+		for (const USceneComponent* Component: Components)
+		{
+			IndicatorManager->AddIndicator(Descriptor, Component);
+		}
+	}
+	TestEqual(TEXT("Indicators added"), IndicatorManager->GetIndicators().Num(), Count);
+	{
+		FScopedMeasure Measure{Results, TEXT("Indicators_Remove"), Count};
+		for (const USceneComponent* Component: Components)
+		{
+			IndicatorManager->RemoveIndicators(Component);
+		}
+	}
+	TestEqual(TEXT("Indicators removed"), IndicatorManager->GetIndicators().Num(), 0);
+	{
+		FScopedMeasure Measure{Results, TEXT("Indicators_AddBulk"), Count};
+		IndicatorManager->AddIndicators(Descriptor, Components);
+	}
+	{
+		FScopedMeasure Measure{Results, TEXT("Indicators_RemoveBulk"), Count};
+		IndicatorManager->RemoveIndicators(Components);
+	}
+	TestEqual(TEXT("Indicators removed in bulk"), IndicatorManager->GetIndicators().Num(), 0);
+
+	TArray<FVector> Locations;
+	Locations.Init(FVector::ZeroVector, Count);
+	TArray<FHUDIndicatorHandle> Handles;
+	{
+		FScopedMeasure Measure{Results, TEXT("Indicators_AddLocations"), Count};
+		IndicatorManager->AddIndicatorsAtLocations(Descriptor, Locations, Handles);
+	}
+	{
+		FScopedMeasure Measure{Results, TEXT("Indicators_RemoveHandles"), Count};
+		IndicatorManager->RemoveIndicators(Handles);
+	}
+	TestEqual(TEXT("Positional indicators removed"), IndicatorManager->GetIndicators().Num(), 0);
+
+	ReportResults(Results);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHUDFrameworkExtensionsBenchmark, "HUDFramework.Benchmarks.Extensions", HUDFrameworkTests::BenchmarkFlags)
+
+/** Register and unregister layout extensions one by one and in a batch, extensions are dispatched to a layout slot that creates their widgets */
+bool FHUDFrameworkExtensionsBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HUDFrameworkTests;
+
+	FTestWorld TestWorld;
+	UHUDLayoutSubsystem* LayoutSubsystem = UHUDLayoutSubsystem::Get(TestWorld.GetWorld());
+	const ULocalPlayer* LocalPlayer = TestWorld.GetLocalPlayer();
+	if (!TestNotNull(TEXT("Layout subsystem"), LayoutSubsystem))
+	{
+		return false;
+	}
+
+	constexpr int32 Count = 1000;
+	const TSubclassOf<UUserWidget> WidgetClass = UHUDFrameworkTestWidget::StaticClass();
+	TArray<FResult> Results;
+
+	// slot creates extension widgets from widget pool, same as layout slot widget does
+	FHUDWidgetPool Pool;
+	Pool.SetWorld(TestWorld.GetWorld());
+	TMap<FHUDLayoutExtensionHandle, UUserWidget*> SlotWidgets;
+	SlotWidgets.Reserve(Count);
+
+	auto AddExtension = [&Pool, &SlotWidgets](const FHUDLayoutExtensionRequest& Request)
+	{
+		UUserWidget* Widget = Pool.GetOrCreateInstance(Request.WidgetClass);
+		SlotWidgets.Add(Request.Handle, Widget);
+		return Widget;
+	};
+	auto RemoveExtension = [&Pool, &SlotWidgets](const FHUDLayoutExtensionRequest& Request)
+	{
+		UUserWidget* Widget = nullptr;
+		if (SlotWidgets.RemoveAndCopyValue(Request.Handle, Widget))
+		{
+			Pool.Release(Widget);
+		}
+		return Widget;
+	};
+	
+	FHUDLayoutSlotHandle SlotHandle = LayoutSubsystem->RegisterLayoutSlot(TAG_HUD_Test_Slot, LocalPlayer, AddExtension, RemoveExtension, EHUDLayoutSlotMatch::ExactMatch,
+		[&AddExtension](TConstArrayView<FHUDLayoutExtensionRequest> Requests, TArray<UUserWidget*>& OutWidgets)
+		{
+			for (const FHUDLayoutExtensionRequest& Request: Requests)
+			{
+				OutWidgets.Add(AddExtension(Request));
+			}
+		});
+
+	TArray<FHUDLayoutExtensionHandle> Handles;
+	Handles.Reserve(Count);
+	{
+		FScopedMeasure Measure{Results, TEXT("Extensions_Register"), Count};
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Handles.Add(LayoutSubsystem->RegisterLayoutExtension(TAG_HUD_Test_Slot, WidgetClass, LocalPlayer));
+		}
+	}
+	TestEqual(TEXT("Extension widgets created"), SlotWidgets.Num(), Count);
+	{
+		FScopedMeasure Measure{Results, TEXT("Extensions_Unregister"), Count};
+		for (FHUDLayoutExtensionHandle& Handle: Handles)
+		{
+			LayoutSubsystem->UnregisterLayoutExtension(Handle);
+		}
+	}
+	TestEqual(TEXT("Extension widgets removed"), SlotWidgets.Num(), 0);
+	Handles.Reset();
+
+	TArray<FHUDLayoutExtensionParams> Params;
+	Params.Init(FHUDLayoutExtensionParams{TAG_HUD_Test_Slot, WidgetClass}, Count);
+	{
+		FScopedMeasure Measure{Results, TEXT("Extensions_RegisterBatch"), Count};
+		Handles = LayoutSubsystem->RegisterLayoutExtensions(Params, LocalPlayer);
+	}
+	TestEqual(TEXT("Batch extension widgets created"), SlotWidgets.Num(), Count);
+	{
+		FScopedMeasure Measure{Results, TEXT("Extensions_UnregisterBatch"), Count};
+		LayoutSubsystem->UnregisterLayoutExtensions(Handles);
+	}
+	TestEqual(TEXT("Batch extension widgets removed"), SlotWidgets.Num(), 0);
+
+	LayoutSubsystem->UnregisterLayoutSlot(SlotHandle);
+	Pool.ResetPool();
+
+	ReportResults(Results);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHUDFrameworkContextWidgetsBenchmark, "HUDFramework.Benchmarks.ContextWidgets", HUDFrameworkTests::BenchmarkFlags)
+
+/** Create deep widget trees and initialize them with widget context */
+bool FHUDFrameworkContextWidgetsBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HUDFrameworkTests;
+
+	FTestWorld TestWorld;
+	UHUDWidgetContextSubsystem* ContextSubsystem = UHUDWidgetContextSubsystem::Get(TestWorld.GetWorld());
+	if (!TestNotNull(TEXT("Widget context subsystem"), ContextSubsystem))
+	{
+		return false;
+	}
+
+	// every tree has 1 + 4 + 16 + 64 widgets
+	constexpr int32 Count = 100;
+	constexpr int32 TreeDepth = 3;
+	constexpr int32 TreeBreadth = 4;
+	TArray<FResult> Results;
+
+	TArray<UHUDFrameworkTestWidget*> Widgets;
+	Widgets.Reserve(Count);
+	{
+		FScopedMeasure Measure{Results, TEXT("ContextWidgets_Create"), Count};
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			UHUDFrameworkTestWidget* Widget = Widgets.Add_GetRef(CreateWidget<UHUDFrameworkTestWidget>(TestWorld.GetWorld()));
+			Widget->AddChildWidgets(TreeDepth, TreeBreadth);
+		}
+	}
+	{
+		FScopedMeasure Measure{Results, TEXT("ContextWidgets_Initialize"), Count};
+		for (UUserWidget* Widget: Widgets)
+		{
+			ContextSubsystem->InitializeWidget(Widget, FHUDWidgetContextHandle::CreateContext<FHUDWidgetContext>());
+		}
+	}
+	TestTrue(TEXT("Widget registered"), ContextSubsystem->IsWidgetRegistered(Widgets[0]));
+	{
+		FScopedMeasure Measure{Results, TEXT("ContextWidgets_Construct"), Count};
+		for (UUserWidget* Widget: Widgets)
+		{
+			Widget->TakeWidget();
+		}
+	}
+	
+	for (UUserWidget* Widget: Widgets)
+	{
+		Widget->ReleaseSlateResources(true);
+		UnregisterWidgetTree(Widget);
+	}
+	TestFalse(TEXT("Widget unregistered"), ContextSubsystem->IsWidgetRegistered(Widgets[0]));
+
+	ReportResults(Results);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHUDFrameworkWidgetPoolBenchmark, "HUDFramework.Benchmarks.WidgetPool", HUDFrameworkTests::BenchmarkFlags)
+
+/** Acquire and release widgets from widget pool */
+bool FHUDFrameworkWidgetPoolBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HUDFrameworkTests;
+
+	FTestWorld TestWorld;
+	const TSubclassOf<UUserWidget> WidgetClass = UHUDFrameworkTestWidget::StaticClass();
+	
+	constexpr int32 Count = 100;
+	constexpr int32 NumIterations = 10;
+	TArray<FResult> Results;
+
+	FHUDWidgetPool Pool;
+	Pool.SetWorld(TestWorld.GetWorld());
+
+	TArray<UUserWidget*> Widgets;
+	Widgets.Reserve(Count);
+	{
+		// first iteration misses the pool
+		FScopedMeasure Measure{Results, TEXT("WidgetPool_Create"), Count};
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Widgets.Add(Pool.GetOrCreateInstance(WidgetClass));
+		}
+	}
+	Pool.Release(Widgets);
+	Widgets.Reset();
+	{
+		FScopedMeasure Measure{Results, TEXT("WidgetPool_Churn"), Count * NumIterations};
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				Widgets.Add(Pool.GetOrCreateInstance(WidgetClass));
+			}
+			Pool.Release(Widgets);
+			Widgets.Reset();
+		}
+	}
+	Pool.ResetPool();
+
+	ReportResults(Results);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHUDFrameworkIndicatorCanvasBenchmark, "HUDFramework.Benchmarks.IndicatorCanvas", HUDFrameworkTests::BenchmarkFlags)
+
+/**
+ * Update and arrange indicator canvas with a mixed workload of indicators, covering every descriptor feature set
+ * Compares arrange loops specialized per feature set with a single generic loop
+ */
+bool FHUDFrameworkIndicatorCanvasBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace HUDFrameworkTests;
+
+	IConsoleVariable* ForceGenericArrange = IConsoleManager::Get().FindConsoleVariable(TEXT("HUD.Indicators.ForceGenericArrange"));
+	if (!TestNotNull(TEXT("HUD.Indicators.ForceGenericArrange"), ForceGenericArrange))
+	{
+		return false;
+	}
+	
+	FTestWorld TestWorld;
+	UHUDIndicatorManagerComponent* IndicatorManager = TestWorld.GetIndicatorManager();
+
+	constexpr int32 Count = 1000;
+	constexpr int32 NumIterations = 100;
+	constexpr int32 MaxMaterializeFrames = 10;
+	const FVector2D ScreenSize{1920.0, 1080.0};
+	TArray<FResult> Results;
+
+	UCurveFloat* ScaleCurve = NewObject<UCurveFloat>(GetTransientPackage());
+	ScaleCurve->FloatCurve.AddKey(0.f, 1.f);
+	ScaleCurve->FloatCurve.AddKey(10000.f, 0.5f);
+
+	// descriptor per feature set
+	TArray<UHUDIndicatorDescriptor*> Descriptors;
+	for (int32 Features = 0; Features < 16; ++Features)
+	{
+		UHUDIndicatorDescriptor* Descriptor = NewObject<UHUDIndicatorDescriptor>(GetTransientPackage());
+		Descriptor->CategoryTag = TAG_HUD_Test_Indicators;
+		Descriptor->ProjectionMode = NewObject<UHUDFrameworkTestProjectionMode>(Descriptor);
+		Descriptor->IndicatorWidgetClass = UHUDFrameworkTestWidget::StaticClass();
+		Descriptor->Priority = Features % 3;
+		Descriptor->bEnableScaling = (Features & 1) != 0;
+		Descriptor->ScaleCurve = ScaleCurve;
+		Descriptor->bClampToScreen = (Features & 2) != 0;
+		Descriptor->bShowClampToScreenArrow = (Features & 4) != 0;
+		Descriptor->bDisplayIndicatorWhenComponentCanNotRender = (Features & 8) != 0;
+		Descriptor->HorizontalAlignment = static_cast<EHorizontalAlignment>(HAlign_Left + Features % 3);
+		Descriptor->BuildRuntimeData();
+		Descriptors.Add(Descriptor);
+	}
+
+	FHUDIndicatorCanvasSettings Settings;
+	Settings.MaxMaterializationsPerFrame = 0;
+
+	// arrows of clamped indicators are added during arrange only if canvas has an arrow brush
+	FSlateBrush ArrowBrush;
+	ArrowBrush.ImageSize = FVector2D{16.0, 16.0};
+	
+	FHUDWidgetPool Pool;
+	TSharedRef<SHUDFrameworkTestIndicatorCanvas> Canvas = SNew(SHUDFrameworkTestIndicatorCanvas, FLocalPlayerContext{TestWorld.GetLocalPlayer()}, FGameplayTagContainer{TAG_HUD_Test_Indicators}, &ArrowBrush)
+		.Settings(Settings);
+	Canvas->SetWidgetPool(&Pool);
+
+	// fake viewport projects world location X and Y to the screen, clamped indicators are placed off the screen as well
+	TArray<FHUDIndicatorHandle> Handles;
+	FRandomStream Random{Count};
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const UHUDIndicatorDescriptor* Descriptor = Descriptors[Random.RandHelper(Descriptors.Num())];
+		const double Margin = Descriptor->bClampToScreen ? 0.25 : 0.0;
+		const FVector Location{
+			Random.FRandRange(-Margin * ScreenSize.X, (1.0 + Margin) * ScreenSize.X),
+			Random.FRandRange(-Margin * ScreenSize.Y, (1.0 + Margin) * ScreenSize.Y),
+			Random.FRandRange(100.f, 10000.f)};
+		Handles.Add(IndicatorManager->AddIndicatorAtLocation(Descriptor, Location));
+	}
+
+	const FGeometry Geometry = FGeometry::MakeRoot(ScreenSize, FSlateLayoutTransform{});
+	double CurrentTime = 0.0;
+	
+	// first update finds indicator manager, widgets are created once their classes are loaded
+	for (int32 Frame = 0; Frame < MaxMaterializeFrames && Canvas->GetNumIndicatorWidgets() < Count; ++Frame)
+	{
+		Canvas->Update(Geometry, CurrentTime += 0.016);
+		TestWorld.TickCoreTicker();
+	}
+	TestEqual(TEXT("Indicator widgets created"), Canvas->GetNumIndicatorWidgets(), Count);
+	
+	{
+		FScopedMeasure Measure{Results, TEXT("IndicatorCanvas_Update"), Count * NumIterations};
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			Canvas->Update(Geometry, CurrentTime += 0.016);
+		}
+	}
+	Canvas->SlatePrepass(1.f);
+	
+	FArrangedChildren ArrangedChildren{EVisibility::Visible};
+	const bool bForceGenericArrange = ForceGenericArrange->GetBool();
+	{
+		ForceGenericArrange->Set(true);
+		FScopedMeasure Measure{Results, TEXT("IndicatorArrange_Generic"), Count * NumIterations};
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			ArrangedChildren.Empty();
+			Canvas->ArrangeChildren(Geometry, ArrangedChildren);
+		}
+	}
+	const TArray<FArrangedWidget> GenericChildren{ArrangedChildren.GetInternalArray()};
+	const TArray<TPair<FVector2D, float>> GenericArrows = Canvas->GetArrows();
+	{
+		ForceGenericArrange->Set(false);
+		FScopedMeasure Measure{Results, TEXT("IndicatorArrange_Specialized"), Count * NumIterations};
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			ArrangedChildren.Empty();
+			Canvas->ArrangeChildren(Geometry, ArrangedChildren);
+		}
+	}
+	ForceGenericArrange->Set(bForceGenericArrange);
+
+	// both arrange paths add children in the same sorted order, each child should get the same geometry
+	constexpr double Tolerance = 0.01;
+	const auto& SpecializedChildren = ArrangedChildren.GetInternalArray();
+	if (TestEqual(TEXT("Generic and specialized arrange the same number of children"), SpecializedChildren.Num(), GenericChildren.Num()))
+	{
+		int32 NumMismatches = 0;
+		for (int32 Index = 0; Index < SpecializedChildren.Num(); ++Index)
+		{
+			const FGeometry& Generic = GenericChildren[Index].Geometry;
+			const FGeometry& Specialized = SpecializedChildren[Index].Geometry;
+			const FVector2D GenericPosition{Generic.GetAbsolutePosition()}, SpecializedPosition{Specialized.GetAbsolutePosition()};
+			const FVector2D GenericSize{Generic.GetAbsoluteSize()}, SpecializedSize{Specialized.GetAbsoluteSize()};
+			
+			if (GenericChildren[Index].Widget != SpecializedChildren[Index].Widget
+				|| !GenericPosition.Equals(SpecializedPosition, Tolerance) || !GenericSize.Equals(SpecializedSize, Tolerance))
+			{
+				// report the first mismatch only, the rest are likely caused by the same feature set
+				if (NumMismatches++ == 0)
+				{
+					AddError(FString::Printf(TEXT("Child %d arranged differently: generic at [%s] size [%s], specialized at [%s] size [%s]"), Index,
+						*GenericPosition.ToString(), *GenericSize.ToString(), *SpecializedPosition.ToString(), *SpecializedSize.ToString()));
+				}
+			}
+		}
+		TestEqual(TEXT("Generic and specialized arrange mismatched children"), NumMismatches, 0);
+	}
+
+	const TArray<TPair<FVector2D, float>> SpecializedArrows = Canvas->GetArrows();
+	if (TestEqual(TEXT("Generic and specialized arrange add the same number of arrows"), SpecializedArrows.Num(), GenericArrows.Num()))
+	{
+		int32 NumMismatches = 0;
+		for (int32 Index = 0; Index < SpecializedArrows.Num(); ++Index)
+		{
+			NumMismatches += !SpecializedArrows[Index].Key.Equals(GenericArrows[Index].Key, Tolerance)
+				|| !FMath::IsNearlyEqual(SpecializedArrows[Index].Value, GenericArrows[Index].Value, 0.01f);
+		}
+		TestEqual(TEXT("Generic and specialized arrange mismatched arrows"), NumMismatches, 0);
+	}
+	ArrangedChildren.Empty();
+
+	// indicator widgets are released back to the pool by the canvas
+	IndicatorManager->RemoveIndicators(Handles);
+	TestEqual(TEXT("Indicator widgets released"), Canvas->GetNumIndicatorWidgets(), 0);
+	Pool.ResetPool();
+
+	ReportResults(Results);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include "Indicators/IndicatorCanvas.h"
+
+/**
+ * Indicator canvas updated by tests instead of its active timer
+ * Indicators are still added and removed through indicator manager
+ */
+class SHUDFrameworkTestIndicatorCanvas: public SIndicatorCanvas
+{
+public:
+	SLATE_BEGIN_ARGS(SHUDFrameworkTestIndicatorCanvas)
+	{}
+		SLATE_ARGUMENT(FHUDIndicatorCanvasSettings, Settings)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const FLocalPlayerContext& InLocalPlayerContext, const FGameplayTagContainer& InCategoryTags, const FSlateBrush* InArrowBrush)
+	{
+		SIndicatorCanvas::Construct(SIndicatorCanvas::FArguments().Settings(InArgs._Settings), InLocalPlayerContext, InCategoryTags, InArrowBrush);
+	}
+
+	/** update canvas as if it was painted with @Geometry */
+	void Update(const FGeometry& Geometry, double CurrentTime)
+	{
+		CachedAllottedGeometry = Geometry;
+		UpdateCanvas(CurrentTime, 0.f);
+	}
+
+	FORCEINLINE int32 GetNumIndicatorWidgets()
+	{
+		return GetChildren()->Num();
+	}
+
+	/** @return position and rotation of clamp arrows added during the last arrange, sorted by position */
+	TArray<TPair<FVector2D, float>> GetArrows() const
+	{
+		TArray<TPair<FVector2D, float>> Arrows;
+		for (const auto& Arrow: ArrowInstances)
+		{
+			Arrows.Emplace(Arrow.Position, Arrow.Rotation);
+		}
+		// arrows are added in arrange order, which differs between generic and specialized arrange
+		Arrows.Sort([](const TPair<FVector2D, float>& A, const TPair<FVector2D, float>& B)
+		{
+			return A.Key.X == B.Key.X ? A.Key.Y < B.Key.Y : A.Key.X < B.Key.X;
+		});
+		return Arrows;
+	}
+};
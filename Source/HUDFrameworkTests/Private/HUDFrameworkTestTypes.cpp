@@ -0,0 +1,57 @@
+﻿#include "HUDFrameworkTestTypes.h"
+
+#include "Blueprint/WidgetTree.h"
+#include "Components/SizeBox.h"
+#include "Components/VerticalBox.h"
+
+UE_DEFINE_GAMEPLAY_TAG(TAG_HUD_Test_Indicators,	"HUD.Test.Indicators");
+UE_DEFINE_GAMEPLAY_TAG(TAG_HUD_Test_Slot,		"HUD.Test.Slot");
+
+int32 UHUDFrameworkTestWidget::NumPaints = 0;
+
+bool UHUDFrameworkTestWidget::Initialize()
+{
+	if (!Super::Initialize())
+	{
+		return false;
+	}
+
+	// native widgets have no widget tree, give widget a size so it is never culled
+	USizeBox* SizeBox = WidgetTree->ConstructWidget<USizeBox>();
+	SizeBox->SetWidthOverride(32.f);
+	SizeBox->SetHeightOverride(32.f);
+	
+	ChildPanel = WidgetTree->ConstructWidget<UVerticalBox>();
+	SizeBox->AddChild(ChildPanel);
+	WidgetTree->RootWidget = SizeBox;
+	
+	return true;
+}
+
+int32 UHUDFrameworkTestWidget::NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	++NumPaints;
+	return Super::NativePaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+}
+
+void UHUDFrameworkTestWidget::AddChildWidgets(int32 Depth, int32 NumChildren)
+{
+	if (Depth <= 0)
+	{
+		return;
+	}
+	
+	for (int32 Index = 0; Index < NumChildren; ++Index)
+	{
+		UHUDFrameworkTestWidget* ChildWidget = WidgetTree->ConstructWidget<UHUDFrameworkTestWidget>();
+		ChildPanel->AddChild(ChildWidget);
+		ChildWidget->AddChildWidgets(Depth - 1, NumChildren);
+	}
+}
+
+void UHUDFrameworkTestProjectionMode::ProjectWorldLocation(const FVector& WorldLocation, const FLocalPlayerContext& PlayerContext, const FVector2f& ScreenSize, FIndicatorProjectionResult& Result) const
+{
+	Result.ScreenPositionWithDepth = WorldLocation;
+	Result.WorldLocation = WorldLocation;
+	Result.bSuccess = true;
+}
@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "NativeGameplayTags.h"
+#include "Indicators/HUDIndicatorProjectionMode.h"
+
+#include "HUDFrameworkTestTypes.generated.h"
+
+class UVerticalBox;
+
+/** indicator category of test canvases */
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_HUD_Test_Indicators);
+/** layout slot registered by tests */
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_HUD_Test_Slot);
+
+/** Native widget with a fixed size, used by automation tests that can't rely on widget blueprints */
+UCLASS(NotBlueprintable, HideDropdown)
+class UHUDFrameworkTestWidget: public UUserWidget
+{
+	GENERATED_BODY()
+public:
+
+	//~Begin UUserWidget interface
+	virtual bool Initialize() override;
+	virtual int32 NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	//~End UUserWidget interface
+
+	/** add @NumChildren test widgets to the widget tree, recursively for @Depth levels */
+	void AddChildWidgets(int32 Depth, int32 NumChildren);
+
+	/** number of times any test widget was painted */
+	static int32 NumPaints;
+
+private:
+
+	UPROPERTY(Transient)
+	TObjectPtr<UVerticalBox> ChildPanel;
+};
+
+/** Projects world location to screen directly: X and Y are used as a screen position, Z as depth */
+UCLASS(NotBlueprintable, HideDropdown)
+class UHUDFrameworkTestProjectionMode: public UHUDIndicatorProjectionMode
+{
+	GENERATED_BODY()
+public:
+
+	virtual void ProjectWorldLocation(const FVector& WorldLocation, const FLocalPlayerContext& PlayerContext, const FVector2f& ScreenSize, FIndicatorProjectionResult& Result) const override;
+};
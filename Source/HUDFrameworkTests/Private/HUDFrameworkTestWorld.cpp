@@ -0,0 +1,111 @@
+﻿#include "HUDFrameworkTestWorld.h"
+
+#include "HUDFramework.h"
+#include "Containers/Ticker.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "Indicators/HUDIndicatorManagerComponent.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace HUDFrameworkTests
+{
+	FTestWorld::FTestWorld()
+	{
+		GameInstance = NewObject<UGameInstance>(GEngine);
+		GameInstance->AddToRoot();
+		// creates world context and a game world, initializes game instance subsystems
+		GameInstance->InitializeStandalone();
+		World = GameInstance->GetWorld();
+		check(World);
+
+		FString Error;
+		LocalPlayer = GameInstance->CreateLocalPlayer(0, Error, false);
+		checkf(LocalPlayer, TEXT("%s"), *Error);
+
+		// local player context is valid only with a player controller
+		PlayerController = World->SpawnActor<APlayerController>();
+		PlayerController->SetPlayer(LocalPlayer);
+
+		AGameStateBase* GameState = World->SpawnActor<AGameStateBase>();
+		World->SetGameState(GameState);
+
+		IndicatorManager = NewObject<UHUDIndicatorManagerComponent>(GameState);
+		IndicatorManager->RegisterComponent();
+	}
+
+	FTestWorld::~FTestWorld()
+	{
+		// removes local players and deinitializes subsystems
+		GameInstance->Shutdown();
+
+		World->DestroyWorld(false);
+		GEngine->DestroyWorldContext(World);
+		GameInstance->RemoveFromRoot();
+	}
+
+	void FTestWorld::TickCoreTicker(float DeltaTime) const
+	{
+		FTSTicker::GetCoreTicker().Tick(DeltaTime);
+	}
+
+	static int64 GetMallocCalls()
+	{
+#if UE_STATS
+		return static_cast<int64>(FMalloc::TotalMallocCalls);
+#else
+		return INDEX_NONE;
+#endif
+	}
+	
+	FScopedMeasure::FScopedMeasure(TArray<FResult>& InResults, const TCHAR* InName, int32 InCount)
+		: Results(InResults)
+		, Name(InName)
+		, Count(InCount)
+		, StartMallocCalls(GetMallocCalls())
+		, StartTime(FPlatformTime::Seconds())
+	{}
+
+	FScopedMeasure::~FScopedMeasure()
+	{
+		const double EndTime = FPlatformTime::Seconds();
+		const int64 EndMallocCalls = GetMallocCalls();
+
+		FResult& Result = Results.AddDefaulted_GetRef();
+		Result.Name = Name;
+		Result.Count = Count;
+		Result.TotalSeconds = EndTime - StartTime;
+		Result.Allocations = StartMallocCalls != INDEX_NONE ? EndMallocCalls - StartMallocCalls : INDEX_NONE;
+	}
+
+	void ReportResults(TConstArrayView<FResult> Results)
+	{
+		const FString FilePath = FPaths::ProfilingDir() / TEXT("HUDFramework") / TEXT("Benchmarks.csv");
+		const bool bWriteHeader = !IFileManager::Get().FileExists(*FilePath);
+
+		FString Csv;
+		if (bWriteHeader)
+		{
+			Csv += TEXT("Timestamp,Benchmark,Count,TotalMs,PerItemUs,Allocations,AllocationsPerItem") LINE_TERMINATOR;
+		}
+
+		const FString Timestamp = FDateTime::Now().ToString();
+		for (const FResult& Result: Results)
+		{
+			const double TotalMs = Result.TotalSeconds * 1000.0;
+			const double PerItemUs = Result.TotalSeconds * 1000000.0 / Result.Count;
+			const double AllocationsPerItem = Result.Allocations != INDEX_NONE ? static_cast<double>(Result.Allocations) / Result.Count : -1.0;
+
+			UE_LOG(LogHUDFramework, Display, TEXT("%s: %d items, %.3f ms, %.3f us per item, %lld allocations"), *Result.Name, Result.Count, TotalMs, PerItemUs, Result.Allocations);
+			Csv += FString::Printf(TEXT("%s,%s,%d,%.3f,%.3f,%lld,%.2f") LINE_TERMINATOR, *Timestamp, *Result.Name, Result.Count, TotalMs, PerItemUs, Result.Allocations, AllocationsPerItem);
+		}
+
+		FFileHelper::SaveStringToFile(Csv, *FilePath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+		UE_LOG(LogHUDFramework, Display, TEXT("Benchmark results written to %s"), *FilePath);
+	}
+}
@@ -0,0 +1,69 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class APlayerController;
+class UGameInstance;
+class UHUDIndicatorManagerComponent;
+class ULocalPlayer;
+class UWorld;
+
+namespace HUDFrameworkTests
+{
+	/**
+	 * Standalone game instance with a game world, a local player with player controller and indicator manager on game state
+	 * Game instance subsystems are created, so tests run the same code paths as a game does. Works with -nullrhi
+	 */
+	class FTestWorld
+	{
+	public:
+		UE_NONCOPYABLE(FTestWorld);
+		
+		FTestWorld();
+		~FTestWorld();
+
+		FORCEINLINE UWorld* GetWorld() const { return World; }
+		FORCEINLINE UGameInstance* GetGameInstance() const { return GameInstance; }
+		FORCEINLINE ULocalPlayer* GetLocalPlayer() const { return LocalPlayer; }
+		FORCEINLINE UHUDIndicatorManagerComponent* GetIndicatorManager() const { return IndicatorManager; }
+
+		/** tick core ticker, deferred async loads are started and completed during ticker tick */
+		void TickCoreTicker(float DeltaTime = 0.f) const;
+		
+	private:
+		UGameInstance* GameInstance = nullptr;
+		UWorld* World = nullptr;
+		ULocalPlayer* LocalPlayer = nullptr;
+		APlayerController* PlayerController = nullptr;
+		UHUDIndicatorManagerComponent* IndicatorManager = nullptr;
+	};
+
+	struct FResult
+	{
+		FString Name;
+		int32 Count = 0;
+		double TotalSeconds = 0.0;
+		/** number of allocations, INDEX_NONE if allocation tracking is not available */
+		int64 Allocations = INDEX_NONE;
+	};
+
+	/** Measures time and number of allocations made during its scope */
+	class FScopedMeasure
+	{
+	public:
+		UE_NONCOPYABLE(FScopedMeasure);
+
+		FScopedMeasure(TArray<FResult>& InResults, const TCHAR* InName, int32 InCount);
+		~FScopedMeasure();
+
+	private:
+		TArray<FResult>& Results;
+		const TCHAR* Name;
+		int32 Count;
+		int64 StartMallocCalls;
+		double StartTime;
+	};
+
+	/** Log benchmark results and append them as CSV to Saved/Profiling/HUDFramework/Benchmarks.csv */
+	void ReportResults(TConstArrayView<FResult> Results);
+}
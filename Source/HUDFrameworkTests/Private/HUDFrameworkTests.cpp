@@ -0,0 +1,4 @@
+﻿#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, HUDFrameworkTests)
\ No newline at end of file
@@ -0,0 +1,93 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HUDFrameworkTestTypes.h"
+#include "HUDFrameworkTestWorld.h"
+#include "HUDLayoutExtension.h"
+#include "HUDLayoutSlot.h"
+#include "HUDLayoutSubsystem.h"
+#include "Blueprint/UserWidget.h"
+#include "Engine/LocalPlayer.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHUDFrameworkLayoutFrameTransactionTest, "HUDFramework.Layout.FrameTransaction",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+/**
+ * Remove and add an equivalent extension within one frame transaction, as Add HUD Layout action does during experience switch
+ * Slot should keep the same extension widget, without removing and creating it again
+ */
+bool FHUDFrameworkLayoutFrameTransactionTest::RunTest(const FString& Parameters)
+{
+	using namespace HUDFrameworkTests;
+
+	FTestWorld TestWorld;
+	UHUDLayoutSubsystem* LayoutSubsystem = UHUDLayoutSubsystem::Get(TestWorld.GetWorld());
+	const ULocalPlayer* LocalPlayer = TestWorld.GetLocalPlayer();
+	if (!TestNotNull(TEXT("Layout subsystem"), LayoutSubsystem))
+	{
+		return false;
+	}
+
+	UWorld* World = TestWorld.GetWorld();
+	const TSubclassOf<UUserWidget> WidgetClass = UHUDFrameworkTestWidget::StaticClass();
+	TMap<FHUDLayoutExtensionHandle, UUserWidget*> SlotWidgets;
+	int32 NumCreated = 0, NumRemoved = 0, NumMoved = 0;
+
+	FHUDLayoutSlotHandle SlotHandle = LayoutSubsystem->RegisterLayoutSlot(TAG_HUD_Test_Slot, LocalPlayer,
+		[World, &SlotWidgets, &NumCreated](const FHUDLayoutExtensionRequest& Request)
+		{
+			UUserWidget* Widget = CreateWidget<UUserWidget>(World, Request.WidgetClass);
+			SlotWidgets.Add(Request.Handle, Widget);
+			++NumCreated;
+			return Widget;
+		},
+		[&SlotWidgets, &NumRemoved](const FHUDLayoutExtensionRequest& Request)
+		{
+			UUserWidget* Widget = nullptr;
+			SlotWidgets.RemoveAndCopyValue(Request.Handle, Widget);
+			++NumRemoved;
+			return Widget;
+		},
+		EHUDLayoutSlotMatch::ExactMatch, nullptr,
+		[&SlotWidgets, &NumMoved](const FHUDLayoutExtensionRequest& From, const FHUDLayoutExtensionRequest& To)
+		{
+			UUserWidget* Widget = nullptr;
+			if (!SlotWidgets.RemoveAndCopyValue(From.Handle, Widget))
+			{
+				return false;
+			}
+			SlotWidgets.Add(To.Handle, Widget);
+			++NumMoved;
+			return true;
+		});
+
+	FHUDLayoutExtensionHandle OldHandle = LayoutSubsystem->RegisterLayoutExtension(TAG_HUD_Test_Slot, WidgetClass, LocalPlayer);
+	UUserWidget* OldWidget = SlotWidgets.FindRef(OldHandle);
+	if (!TestNotNull(TEXT("Extension widget created"), OldWidget))
+	{
+		LayoutSubsystem->UnregisterLayoutSlot(SlotHandle);
+		return false;
+	}
+
+	// same frame remove and add, committed at the end of the frame
+	LayoutSubsystem->BeginFrameTransaction();
+	LayoutSubsystem->UnregisterLayoutExtension(OldHandle);
+	FHUDLayoutExtensionHandle NewHandle = LayoutSubsystem->RegisterLayoutExtension(TAG_HUD_Test_Slot, WidgetClass, LocalPlayer);
+	TestTrue(TEXT("Frame transaction is active"), LayoutSubsystem->IsFrameTransactionActive());
+	TestEqual(TEXT("Slot is not notified before commit"), NumCreated + NumRemoved + NumMoved, 1);
+	LayoutSubsystem->CommitFrameTransaction();
+
+	TestEqual(TEXT("Slot holds one extension widget"), SlotWidgets.Num(), 1);
+	TestTrue(TEXT("Slot keeps the same widget instance"), SlotWidgets.FindRef(NewHandle) == OldWidget);
+	TestEqual(TEXT("Extension widget moved"), NumMoved, 1);
+	TestEqual(TEXT("Extension widget not removed"), NumRemoved, 0);
+	TestEqual(TEXT("Extension widget not created again"), NumCreated, 1);
+
+	LayoutSubsystem->UnregisterLayoutExtension(NewHandle);
+	LayoutSubsystem->UnregisterLayoutSlot(SlotHandle);
+	return true;
+}
+
+#endif
@@ -0,0 +1,241 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HUDFrameworkTestIndicatorCanvas.h"
+#include "HUDFrameworkTestTypes.h"
+#include "HUDFrameworkTestWorld.h"
+#include "HUDWidgetPool.h"
+#include "Debugging/SlateDebugging.h"
+#include "Indicators/HUDIndicatorDescriptor.h"
+#include "Indicators/HUDIndicatorManagerComponent.h"
+#include "Input/HittestGrid.h"
+#include "Rendering/DrawElements.h"
+#include "Widgets/SInvalidationPanel.h"
+#include "Widgets/SLeafWidget.h"
+#include "Widgets/SOverlay.h"
+#include "Widgets/SWindow.h"
+
+namespace HUDFrameworkTests
+{
+	/** Leaf widget that counts its prepasses and paints */
+	class SCounterWidget: public SLeafWidget
+	{
+	public:
+		SLATE_BEGIN_ARGS(SCounterWidget)
+		{}
+		SLATE_END_ARGS()
+
+		void Construct(const FArguments& InArgs)
+		{}
+
+		virtual FVector2D ComputeDesiredSize(float) const override
+		{
+			++NumPrepasses;
+			return FVector2D{100.0, 100.0};
+		}
+
+		virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override
+		{
+			++NumPaints;
+			return LayerId;
+		}
+
+		mutable int32 NumPrepasses = 0;
+		mutable int32 NumPaints = 0;
+	};
+
+	/** Widgets painted and invalidated during a single frame */
+	struct FFrameStats
+	{
+		int32 IndicatorsPainted = 0;
+		int32 SiblingPaints = 0;
+		int32 SiblingPrepasses = 0;
+		int32 CanvasPaintInvalidations = 0;
+		int32 CanvasLayoutInvalidations = 0;
+
+		FString ToString() const
+		{
+			return FString::Printf(TEXT("indicators painted %d, sibling painted %d, sibling prepassed %d, canvas invalidated for paint %d, for layout %d"),
+				IndicatorsPainted, SiblingPaints, SiblingPrepasses, CanvasPaintInvalidations, CanvasLayoutInvalidations);
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHUDFrameworkIndicatorCanvasInvalidationTest, "HUDFramework.Indicators.CanvasInvalidation",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+/**
+ * Paint indicator canvas next to a sibling widget under an invalidation panel
+ * Moved indicators should repaint only the canvas, without prepass or repaint of its siblings
+ * Frame with layout invalidation of the canvas parent is measured for comparison. Canvas did it before it became paint only,
+ * by toggling visibility of indicator slots which invalidated layout up to the invalidation root
+ */
+bool FHUDFrameworkIndicatorCanvasInvalidationTest::RunTest(const FString& Parameters)
+{
+	using namespace HUDFrameworkTests;
+
+	FTestWorld TestWorld;
+	UHUDIndicatorManagerComponent* IndicatorManager = TestWorld.GetIndicatorManager();
+
+	constexpr int32 Count = 50;
+	constexpr int32 MaxMaterializeFrames = 10;
+	const FVector2D ScreenSize{1920.0, 1080.0};
+
+	UHUDIndicatorDescriptor* Descriptor = NewObject<UHUDIndicatorDescriptor>(GetTransientPackage());
+	Descriptor->CategoryTag = TAG_HUD_Test_Indicators;
+	Descriptor->ProjectionMode = NewObject<UHUDFrameworkTestProjectionMode>(Descriptor);
+	Descriptor->IndicatorWidgetClass = UHUDFrameworkTestWidget::StaticClass();
+	Descriptor->BuildRuntimeData();
+
+	TArray<FHUDIndicatorHandle> Handles;
+	TArray<FVector> Locations;
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		Locations.Add(FVector{100.0 + Index * 30.0, 100.0 + Index * 15.0, 1000.0});
+	}
+	IndicatorManager->AddIndicatorsAtLocations(Descriptor, Locations, Handles);
+
+	FHUDIndicatorCanvasSettings Settings;
+	Settings.MaxMaterializationsPerFrame = 0;
+	
+	FHUDWidgetPool Pool;
+	TSharedRef<SHUDFrameworkTestIndicatorCanvas> Canvas = SNew(SHUDFrameworkTestIndicatorCanvas, FLocalPlayerContext{TestWorld.GetLocalPlayer()}, FGameplayTagContainer{TAG_HUD_Test_Indicators}, nullptr)
+		.Settings(Settings);
+	Canvas->SetWidgetPool(&Pool);
+
+	TSharedRef<SCounterWidget> Sibling = SNew(SCounterWidget);
+	TSharedRef<SOverlay> Overlay = SNew(SOverlay)
+		+ SOverlay::Slot()
+		[
+			Sibling
+		]
+		+ SOverlay::Slot()
+		[
+			Canvas
+		];
+	TSharedRef<SInvalidationPanel> Panel = SNew(SInvalidationPanel)
+	[
+		Overlay
+	];
+	Panel->SetCanCache(true);
+	if (!Panel->GetCanCache())
+	{
+		// without caching every widget is painted every frame, painted widget counts would verify nothing
+		AddWarning(TEXT("Skipped: invalidation panel can't cache, check Slate.EnableInvalidationPanels"));
+		IndicatorManager->RemoveIndicators(Handles);
+		return true;
+	}
+	
+	TSharedRef<SWindow> Window = SNew(SWindow)
+		.ClientSize(ScreenSize)
+		.CreateTitleBar(false)
+	[
+		Panel
+	];
+
+	const FGeometry Geometry = FGeometry::MakeRoot(ScreenSize, FSlateLayoutTransform{});
+	const FSlateRect CullingRect{FVector2D::ZeroVector, ScreenSize};
+	FHittestGrid HittestGrid;
+	FSlateWindowElementList ElementList{Window};
+	double CurrentTime = 0.0;
+
+	for (int32 Frame = 0; Frame < MaxMaterializeFrames && Canvas->GetNumIndicatorWidgets() < Count; ++Frame)
+	{
+		Canvas->Update(Geometry, CurrentTime += 0.016);
+		TestWorld.TickCoreTicker();
+	}
+	TestEqual(TEXT("Indicator widgets created"), Canvas->GetNumIndicatorWidgets(), Count);
+
+	FFrameStats FrameStats;
+#if WITH_SLATE_DEBUGGING
+	const FDelegateHandle InvalidateHandle = FSlateDebugging::WidgetInvalidateEvent.AddLambda([&FrameStats, CanvasWidget = &Canvas.Get()](const FSlateDebuggingInvalidateArgs& Args)
+	{
+		if (Args.WidgetInvalidated == CanvasWidget)
+		{
+			FrameStats.CanvasPaintInvalidations += EnumHasAnyFlags(Args.InvalidateWidgetReason, EInvalidateWidgetReason::Paint);
+			FrameStats.CanvasLayoutInvalidations += EnumHasAnyFlags(Args.InvalidateWidgetReason, EInvalidateWidgetReason::Layout);
+		}
+	});
+#else
+	AddWarning(TEXT("Slate debugging is disabled, canvas invalidations are not verified"));
+#endif
+	
+	// update canvas and paint the whole panel, @Invalidate runs between update and paint
+	auto PaintFrame = [&](TFunctionRef<void()> Invalidate)
+	{
+		FrameStats = FFrameStats{};
+		UHUDFrameworkTestWidget::NumPaints = 0;
+		Sibling->NumPaints = 0;
+		Sibling->NumPrepasses = 0;
+
+		CurrentTime += 0.016;
+		Canvas->Update(Geometry, CurrentTime);
+		Invalidate();
+		
+		const FPaintArgs PaintArgs{&Window.Get(), HittestGrid, FVector2f::ZeroVector, CurrentTime, 0.016f};
+		Panel->Paint(PaintArgs, Geometry, CullingRect, ElementList, 0, FWidgetStyle{}, true);
+		ElementList.ResetElementList();
+
+		FrameStats.IndicatorsPainted = UHUDFrameworkTestWidget::NumPaints;
+		FrameStats.SiblingPaints = Sibling->NumPaints;
+		FrameStats.SiblingPrepasses = Sibling->NumPrepasses;
+		return FrameStats;
+	};
+	
+	auto MoveIndicators = [&]()
+	{
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Locations[Index].X += 10.0;
+			IndicatorManager->SetIndicatorLocation(Handles[Index], Locations[Index]);
+		}
+	};
+
+	// first frame paints everything
+	Panel->SlatePrepass(1.f);
+	const FFrameStats FirstFrame = PaintFrame([] {});
+	AddInfo(FString::Printf(TEXT("First frame: %s"), *FirstFrame.ToString()));
+	TestEqual(TEXT("Every indicator is painted during the first frame"), FirstFrame.IndicatorsPainted, Count);
+
+	// nothing changed, cached panel doesn't repaint anything
+	const FFrameStats StaticFrame = PaintFrame([] {});
+	AddInfo(FString::Printf(TEXT("Static frame: %s"), *StaticFrame.ToString()));
+#if WITH_SLATE_DEBUGGING
+	TestEqual(TEXT("Canvas is not invalidated if indicators didn't change"), StaticFrame.CanvasPaintInvalidations + StaticFrame.CanvasLayoutInvalidations, 0);
+#endif
+	TestEqual(TEXT("Indicators are not repainted if they didn't change"), StaticFrame.IndicatorsPainted, 0);
+	TestEqual(TEXT("Sibling is not repainted if indicators didn't change"), StaticFrame.SiblingPaints, 0);
+
+	// moved indicators invalidate canvas paint only
+	MoveIndicators();
+	const FFrameStats MovedFrame = PaintFrame([] {});
+	AddInfo(FString::Printf(TEXT("Moved indicators: %s"), *MovedFrame.ToString()));
+	TestEqual(TEXT("Every moved indicator is repainted"), MovedFrame.IndicatorsPainted, Count);
+	TestEqual(TEXT("Sibling of the canvas is not prepassed"), MovedFrame.SiblingPrepasses, 0);
+	TestEqual(TEXT("Sibling of the canvas is not repainted"), MovedFrame.SiblingPaints, 0);
+#if WITH_SLATE_DEBUGGING
+	TestEqual(TEXT("Canvas is invalidated for paint once"), MovedFrame.CanvasPaintInvalidations, 1);
+	TestEqual(TEXT("Canvas is not invalidated for layout"), MovedFrame.CanvasLayoutInvalidations, 0);
+#endif
+
+	// same frame with layout invalidation of the canvas parent, as visibility toggles of indicator slots did before
+	MoveIndicators();
+	const FFrameStats LayoutFrame = PaintFrame([&Overlay] { Overlay->Invalidate(EInvalidateWidgetReason::Layout); });
+	AddInfo(FString::Printf(TEXT("Moved indicators with layout invalidation: %s"), *LayoutFrame.ToString()));
+	TestTrue(FString::Printf(TEXT("Paint invalidation paints fewer widgets per frame than layout invalidation (%d vs %d)"),
+		MovedFrame.IndicatorsPainted + MovedFrame.SiblingPaints, LayoutFrame.IndicatorsPainted + LayoutFrame.SiblingPaints),
+		MovedFrame.IndicatorsPainted + MovedFrame.SiblingPaints < LayoutFrame.IndicatorsPainted + LayoutFrame.SiblingPaints);
+	TestTrue(TEXT("Paint invalidation doesn't prepass more widgets than layout invalidation"), MovedFrame.SiblingPrepasses <= LayoutFrame.SiblingPrepasses);
+
+#if WITH_SLATE_DEBUGGING
+	FSlateDebugging::WidgetInvalidateEvent.Remove(InvalidateHandle);
+#endif
+
+	IndicatorManager->RemoveIndicators(Handles);
+	Pool.ResetPool();
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS